@@ -5,6 +5,7 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
+flat in vec3 InstanceColor;
 
 uniform bool useColor;
 
@@ -18,30 +19,37 @@ struct Material
 
 uniform Material material;
 
+// std140 layout mirrored by GPULight (src/rendering/UniformBlocks.cppm)
 struct Light 
 {
     int type; 
+    float constant;
+    float linear;
+    float quadratic;
     
     vec3 position;
+    float innerCutoff;
     vec3 direction;
+    float outerCutoff;
     
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
-    
-    float constant;
-    float linear;
-    float quadratic;
-    
-    float innerCutoff;
-    float outerCutoff;
 };
 
 #define MAX_LIGHTS 8
-uniform Light lights[MAX_LIGHTS];
-uniform int numLights;
+layout (std140) uniform Lights
+{
+    Light lights[MAX_LIGHTS];
+    int numLights;
+};
 
-uniform vec3 viewPos;
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+};
 
 vec3 CalcDirectionalLight(Light light, vec3 normal, vec3 viewDir, vec3 objectColor)
 {
@@ -117,12 +125,12 @@ vec3 CalcSpotLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 ob
 void main()
 {
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     
     vec3 color;
     if (useColor)
     {
-        color = material.color;
+        color = InstanceColor;
     }
     else
     {
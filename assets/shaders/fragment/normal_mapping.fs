@@ -32,8 +32,11 @@ void main()
         discard;
 
     // Получение нормали из карты нормалей
-    vec3 normal = texture(normalMap, texCoords).rgb;
-    normal = normalize(normal * 2.0 - 1.0);   
+    // Только XY: кеш хранит карты нормалей в BC5/RG8, Z восстанавливается
+    vec3 normal;
+    normal.xy = texture(normalMap, texCoords).rg * 2.0 - 1.0;
+    normal.z = sqrt(max(1.0 - dot(normal.xy, normal.xy), 0.0));
+    normal = normalize(normal);
    
     // Получение диффузного цвета
     vec3 color = texture(diffuseMap, texCoords).rgb;
@@ -4,19 +4,28 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
+// per-instance
+layout (location = 5) in mat4 aInstanceModel;
+layout (location = 9) in vec3 aInstanceColor;
+
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+flat out vec3 InstanceColor;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+};
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(aInstanceModel * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(aInstanceModel))) * aNormal;
     TexCoords = aTexCoords;
+    InstanceColor = aInstanceColor;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
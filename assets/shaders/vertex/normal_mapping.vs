@@ -2,8 +2,8 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in vec3 aTangent;
-layout (location = 4) in vec3 aBitangent;
+layout (location = 3) in vec4 aTangent;     // cooked meshes: w = bitangent sign
+layout (location = 4) in vec3 aBitangent;   // zero when not supplied
 
 out VS_OUT {
     vec3 FragPos;
@@ -25,8 +25,12 @@ void main()
     vs_out.FragPos = vec3(model * vec4(aPos, 1.0));   
     vs_out.TexCoords = aTexCoords;   
     
-    vec3 T = normalize(mat3(model) * aTangent);
-    vec3 B = normalize(mat3(model) * aBitangent);
+    vec3 bitangent = dot(aBitangent, aBitangent) > 0.0
+        ? aBitangent
+        : cross(aNormal, aTangent.xyz) * (aTangent.w < 0.0 ? -1.0 : 1.0);
+
+    vec3 T = normalize(mat3(model) * aTangent.xyz);
+    vec3 B = normalize(mat3(model) * bitangent);
     vec3 N = normalize(mat3(model) * aNormal);
     mat3 TBN = transpose(mat3(T, B, N));
 
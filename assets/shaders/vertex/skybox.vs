@@ -3,12 +3,17 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos;
+};
 
 void main() 
 {
     TexCoords = aPos;
-    vec4 pos = projection * view * vec4(aPos, 1.0);
+    mat4 skyView = mat4(mat3(view)); // drop translation
+    vec4 pos = projection * skyView * vec4(aPos, 1.0);
     gl_Position = pos.xyww;
 }
\ No newline at end of file
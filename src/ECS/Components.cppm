@@ -2,13 +2,17 @@ module;
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <entt.hpp>
 #include <string>
 #include <memory>
+#include <vector>
+#include <cstdint>
 
 export module XEngine.ECS.Components;
 
 import XEngine.Scene.Mesh;
 
+import XEngine.Rendering.Bounds;
 import XEngine.Rendering.Material;
 import XEngine.Rendering.Light;
 
@@ -49,6 +53,52 @@ export struct TransformComponent
         model = glm::scale(model, scale);
         return model;
     }
+
+    bool operator == (const TransformComponent& other) const = default;
+};
+
+// Cached world matrix, maintained by TransformSystem. Rebuilt only when the
+// local transform, the parent or any ancestor's world matrix changes.
+export struct WorldTransformComponent
+{
+    glm::mat4 world{1.0f};
+    glm::mat4 local{1.0f};
+
+    // Local transform the cached matrices were built from
+    TransformComponent source;
+
+    entt::entity parent = entt::null;
+    uint32_t parentVersion = 0;
+    uint32_t version = 0;       // bumped on every rebuild
+    bool initialized = false;
+
+    glm::vec3 GetPosition() const { return glm::vec3(world[3]); }
+};
+
+// Present only on entities that take part in a hierarchy
+export struct HierarchyComponent
+{
+    entt::entity parent = entt::null;
+    std::vector<entt::entity> children;
+    uint32_t depth = 0;
+};
+
+// World bounds of a mesh entity and its proxy in the world's render BVH,
+// maintained by SpatialSystem
+export struct BoundsComponent
+{
+    AABB world;
+    int proxy = -1;
+    uint32_t transformVersion = 0;
+    const void* source = nullptr;   // mesh the bounds were built from
+};
+
+// Sphere of influence of a point or spot light and its proxy in the light BVH
+export struct LightBoundsComponent
+{
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+    int proxy = -1;
 };
 
 export struct MeshComponent 
@@ -144,16 +194,31 @@ export struct LightComponent
         }
     }
     
-    void SyncWithTransform(const TransformComponent& transform)
+    // Distance at which the light falls below 1/256 of its peak, capped by radius
+    float GetRange() const
     {
-        position = transform.position;
-        
-        glm::mat4 rotMat = glm::mat4(1.0f);
-        rotMat = glm::rotate(rotMat, glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
-        rotMat = glm::rotate(rotMat, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
-        rotMat = glm::rotate(rotMat, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
+        float peak = intensity * glm::max(diffuse.r, glm::max(diffuse.g, diffuse.b));
+        if (peak <= 0.0f)
+            return 0.0f;
+
+        float c = constant - 256.0f * peak;
+        if (c >= 0.0f)
+            return 0.0f;
+
+        float range = radius;
+        if (quadratic > 0.0f)
+            range = (-linear + glm::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+        else if (linear > 0.0f)
+            range = -c / linear;
+
+        return glm::clamp(range, 0.0f, radius);
+    }
+
+    void SyncWithTransform(const WorldTransformComponent& transform)
+    {
+        position = transform.GetPosition();
         
-        glm::vec4 dir = rotMat * glm::vec4(0.0f, -1.0f, 0.0f, 0.0f);
+        glm::vec4 dir = transform.world * glm::vec4(0.0f, -1.0f, 0.0f, 0.0f);
         direction = glm::normalize(glm::vec3(dir));
     }
 };
\ No newline at end of file
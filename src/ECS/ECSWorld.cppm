@@ -2,22 +2,93 @@ module;
 
 #include <entt.hpp>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <cstdint>
 
 export module XEngine.ECS.ECSWorld;
 
 import XEngine.ECS.Components;
 import XEngine.Core.Logger;
+import XEngine.Scene.BVH;
 
 export class ECSWorld 
 {
 private:
     entt::registry registry;
     uint64_t nextID = 1;
+    bool hierarchyChanged = false;
+
+    // Spatial indices over world bounds, kept up to date by SpatialSystem
+    DynamicBVH renderTree;
+    DynamicBVH lightTree{ 0.5f };
+
+    // Every transform gets a cached world matrix maintained by TransformSystem
+    void OnTransformConstruct(entt::registry& reg, entt::entity entity)
+    {
+        reg.emplace_or_replace<WorldTransformComponent>(entity);
+    }
+
+    void OnTransformDestroy(entt::registry& reg, entt::entity entity)
+    {
+        reg.remove<WorldTransformComponent, BoundsComponent, LightBoundsComponent>(entity);
+    }
+
+    void OnMeshDestroy(entt::registry& reg, entt::entity entity)
+    {
+        reg.remove<BoundsComponent>(entity);
+    }
+
+    void OnLightDestroy(entt::registry& reg, entt::entity entity)
+    {
+        reg.remove<LightBoundsComponent>(entity);
+    }
+
+    void OnBoundsDestroy(entt::registry& reg, entt::entity entity)
+    {
+        renderTree.DestroyProxy(reg.get<BoundsComponent>(entity).proxy);
+    }
+
+    void OnLightBoundsDestroy(entt::registry& reg, entt::entity entity)
+    {
+        lightTree.DestroyProxy(reg.get<LightBoundsComponent>(entity).proxy);
+    }
+
+    void UpdateDepth(entt::entity entity, uint32_t depth)
+    {
+        auto& node = registry.get<HierarchyComponent>(entity);
+        node.depth = depth;
+        for (auto child : node.children)
+            UpdateDepth(child, depth + 1);
+    }
+
+    void Detach(entt::entity child)
+    {
+        auto* node = registry.try_get<HierarchyComponent>(child);
+        if (!node || node->parent == entt::null)
+            return;
+
+        if (auto* parentNode = registry.try_get<HierarchyComponent>(node->parent))
+        {
+            auto& siblings = parentNode->children;
+            siblings.erase(std::remove(siblings.begin(), siblings.end(), child), siblings.end());
+        }
+
+        node->parent = entt::null;
+        UpdateDepth(child, 0);
+        hierarchyChanged = true;
+    }
     
 public:
     ECSWorld() 
     {
+        registry.on_construct<TransformComponent>().connect<&ECSWorld::OnTransformConstruct>(*this);
+        registry.on_destroy<TransformComponent>().connect<&ECSWorld::OnTransformDestroy>(*this);
+        registry.on_destroy<MeshComponent>().connect<&ECSWorld::OnMeshDestroy>(*this);
+        registry.on_destroy<LightComponent>().connect<&ECSWorld::OnLightDestroy>(*this);
+        registry.on_destroy<BoundsComponent>().connect<&ECSWorld::OnBoundsDestroy>(*this);
+        registry.on_destroy<LightBoundsComponent>().connect<&ECSWorld::OnLightBoundsDestroy>(*this);
+
         Logger::Log(LogLevel::INFO, "ECS World initialized");
     }
     
@@ -37,10 +108,74 @@ public:
         return entity;
     }
     
+    // Destroys the entity together with all of its descendants
     void DestroyEntity(entt::entity entity) 
     {
-        if (registry.valid(entity)) 
-            registry.destroy(entity);
+        if (!registry.valid(entity)) 
+            return;
+
+        if (auto* node = registry.try_get<HierarchyComponent>(entity))
+        {
+            Detach(entity);
+
+            std::vector<entt::entity> children = node->children;
+            for (auto child : children)
+                DestroyEntity(child);
+
+            hierarchyChanged = true;
+        }
+
+        registry.destroy(entity);
+    }
+
+    // Pass entt::null to make the entity a root again. Refuses to create cycles.
+    bool SetParent(entt::entity child, entt::entity parent)
+    {
+        if (!registry.valid(child) || child == parent)
+            return false;
+
+        if (parent != entt::null)
+        {
+            if (!registry.valid(parent))
+                return false;
+
+            for (auto* node = registry.try_get<HierarchyComponent>(parent); node && node->parent != entt::null;
+                 node = registry.try_get<HierarchyComponent>(node->parent))
+                if (node->parent == child)
+                {
+                    Logger::Log(LogLevel::WARNING, "SetParent rejected: would create a cycle");
+                    return false;
+                }
+        }
+
+        registry.get_or_emplace<HierarchyComponent>(child);
+        Detach(child);
+
+        if (parent != entt::null)
+        {
+            auto& parentNode = registry.get_or_emplace<HierarchyComponent>(parent);
+            parentNode.children.push_back(child);
+
+            registry.get<HierarchyComponent>(child).parent = parent;
+            UpdateDepth(child, parentNode.depth + 1);
+        }
+
+        hierarchyChanged = true;
+        return true;
+    }
+
+    entt::entity GetParent(entt::entity entity) const
+    {
+        const auto* node = registry.try_get<HierarchyComponent>(entity);
+        return node ? node->parent : entt::null;
+    }
+
+    // True once after any parent/child change; TransformSystem re-sorts on it
+    bool ConsumeHierarchyChanged()
+    {
+        bool changed = hierarchyChanged;
+        hierarchyChanged = false;
+        return changed;
     }
     
     bool IsValid(entt::entity entity) const 
@@ -88,7 +223,10 @@ public:
     void Clear() 
     {
         registry.clear();
+        renderTree.Clear();
+        lightTree.Clear();
         nextID = 1;
+        hierarchyChanged = true;
     }
     
     size_t GetEntityCount() const 
@@ -97,4 +235,7 @@ public:
     }
     
     entt::registry& GetRegistry() { return registry; }
+
+    DynamicBVH& GetRenderTree() { return renderTree; }
+    DynamicBVH& GetLightTree() { return lightTree; }
 };
\ No newline at end of file
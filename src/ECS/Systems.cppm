@@ -4,133 +4,491 @@ module;
 #include <glm/glm.hpp>
 
 #include <string>
+#include <vector>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 export module XEngine.ECS.Systems;
 
 import XEngine.ECS.Components; 
 import XEngine.ECS.ECSWorld;
 
-import XEngine.Core.Camera;
 import XEngine.Core.Logger;
+import XEngine.Core.ThreadPool;
 
 import XEngine.Resource.Shader.ShaderManager; 
 
+import XEngine.Scene.BVH;
+import XEngine.Scene.Mesh;
+
+import XEngine.Rendering.Bounds;
 import XEngine.Rendering.Light;
+import XEngine.Rendering.Material;
+import XEngine.Rendering.RenderQueue;
+import XEngine.Rendering.UniformBlocks;
 
 export class RenderSystem 
 {
+private:
+    RenderQueue queue;
+    std::vector<entt::entity> visible;
+
+    // Shared by every entity that has a ColorComponent but no material, so they
+    // batch together; the colour itself goes in per instance
+    Material fallbackMaterial{ glm::vec3(1.0f), "fallback_color" };
+
 public:
-    void Update(ECSWorld& world, ShaderManager& shaderManager, const std::string& name, Camera& camera) 
+    void Update(ECSWorld& world, ShaderManager& shaderManager, const std::string& name, 
+                const Frustum& frustum, CullingStats& culling) 
     {
-        shaderManager.Bind(name);
-        
-        world.Each<TransformComponent, MeshComponent, MaterialComponent, VisibilityComponent>(
-            [&](entt::entity entity, 
-                TransformComponent& transform,
-                MeshComponent& meshComp,
-                MaterialComponent& matComp,
-                VisibilityComponent& vis) 
+        ShaderHandle shader = shaderManager.GetHandle(name);
+        if (!shader.IsValid())
+            return;
+
+        auto& registry = world.GetRegistry();
+        auto start = std::chrono::steady_clock::now();
+
+        visible.clear();
+        world.GetRenderTree().QueryFrustum(frustum, [&](uint32_t id)
+        {
+            visible.push_back(static_cast<entt::entity>(id));
+        });
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        culling.frustumQueryMs = elapsed.count();
+        culling.visible = visible.size();
+        culling.culled = world.GetRenderTree().GetProxyCount() - visible.size();
+
+        queue.Begin();
+
+        for (entt::entity entity : visible)
         {
-            if (!vis.isActive || !vis.visible) return;
-            
-            shaderManager.SetMat4(name, "model", transform.GetModelMatrix());
-        
-            if (matComp.material)
+            if (!registry.all_of<WorldTransformComponent, MeshComponent, MaterialComponent, VisibilityComponent>(entity))
+                continue;
+
+            auto [transform, meshComp, matComp, vis] = 
+                registry.get<WorldTransformComponent, MeshComponent, MaterialComponent, VisibilityComponent>(entity);
+
+            if (!vis.isActive || !vis.visible || !meshComp.mesh) continue;
+
+            Material* material = matComp.material.get();
+            glm::vec3 color;
+            if (material)
             {
-                static int frameCount = 0;
-                if (frameCount % 300 == 0)
-                    Logger::Log(LogLevel::DEBUG, LogCategory::RENDERING, 
-                        "Binding material: " + matComp.material->GetName());
-                frameCount++;
-                
-                if (meshComp.mesh) 
-                    meshComp.mesh->Draw(shaderManager, name, matComp.material);
+                color = material->GetColor();
             }
-            else if (world.HasComponent<ColorComponent>(entity)) 
+            else if (auto* colorComp = registry.try_get<ColorComponent>(entity))
             {
-                auto& color = world.GetComponent<ColorComponent>(entity);
-                if (meshComp.mesh) 
-                    meshComp.mesh->SetColor(color.color);
-                
-                if (meshComp.mesh)
-                    meshComp.mesh->Draw(shaderManager, name);
+                material = &fallbackMaterial;
+                color = colorComp->color;
             }
             else
             {
-                if (meshComp.mesh)
-                    meshComp.mesh->Draw(shaderManager, name);
+                material = meshComp.mesh->GetMaterial().get();
+                if (!material) continue;
+                color = material->GetColor();
             }
-        });
+
+            queue.Submit(shader, meshComp.mesh->GetGPUMesh(), material, transform.world, color);
+        }
+
+        queue.Flush(shaderManager, shader);
 
         shaderManager.Unbind();
     }
+
+    const RenderStats& GetStats() const { return queue.GetStats(); }
 };
 
 export class RotationSystem 
 {
+private:
+    size_t chunkSize = 4096;
+
 public:
-    void Update(ECSWorld& world, float deltaTime) 
+    void Update(ECSWorld& world, ThreadPool& pool, float deltaTime) 
     {
-        world.Each<TransformComponent, RotationComponent>(
-            [&](entt::entity entity, 
-                TransformComponent& transform,
-                RotationComponent& rotation) 
+        auto& registry = world.GetRegistry();
+        auto& rotations = registry.storage<RotationComponent>();
+        auto& transforms = registry.storage<TransformComponent>();
+
+        const entt::entity* entities = rotations.data();
+
+        pool.ParallelFor(rotations.size(), chunkSize, [&](size_t begin, size_t end)
         {
-            if (rotation.autoRotate) 
-                transform.rotation += rotation.axis * rotation.speed * deltaTime;
+            for (size_t i = begin; i < end; i++)
+            {
+                entt::entity entity = entities[i];
+                const RotationComponent& rotation = rotations.get(entity);
+
+                if (rotation.autoRotate && transforms.contains(entity)) 
+                    transforms.get(entity).rotation += rotation.axis * rotation.speed * deltaTime;
+            }
         });
     }
+
+    void SetChunkSize(size_t size) { chunkSize = size; }
 };
 
-export class LightSystem
+// Keeps WorldTransformComponent in sync with TransformComponent and the hierarchy.
+// Entities outside any hierarchy are refreshed in one parallel sweep over the
+// world-transform storage; hierarchical ones are sorted by depth and refreshed
+// level by level, so parents are always final before their children read them.
+export class TransformSystem
 {
+private:
+    size_t chunkSize = 2048;
+    size_t lastUpdated = 0;
+
+    std::vector<std::pair<size_t, size_t>> levels; // [begin, end) in the sorted hierarchy storage
+
+    static bool Refresh(const TransformComponent& transform, WorldTransformComponent& cached,
+                        entt::entity parent, const WorldTransformComponent* parentWorld)
+    {
+        bool localChanged = !cached.initialized || !(transform == cached.source);
+        bool parentChanged = parent != cached.parent || 
+            (parentWorld && parentWorld->version != cached.parentVersion);
+
+        if (!localChanged && !parentChanged)
+            return false;
+
+        if (localChanged)
+        {
+            cached.local = transform.GetModelMatrix();
+            cached.source = transform;
+        }
+
+        cached.world = parentWorld ? parentWorld->world * cached.local : cached.local;
+        cached.parent = parent;
+        cached.parentVersion = parentWorld ? parentWorld->version : 0;
+        cached.version++;
+        cached.initialized = true;
+        return true;
+    }
+
+    void RebuildLevels(entt::registry& registry)
+    {
+        registry.sort<HierarchyComponent>([](const HierarchyComponent& a, const HierarchyComponent& b) 
+        { 
+            return a.depth < b.depth; 
+        });
+
+        auto& hierarchy = registry.storage<HierarchyComponent>();
+        const entt::entity* entities = hierarchy.data();
+
+        levels.clear();
+        for (size_t i = 0; i < hierarchy.size(); i++)
+        {
+            uint32_t depth = hierarchy.get(entities[i]).depth;
+            if (levels.empty() || depth != hierarchy.get(entities[levels.back().first]).depth)
+                levels.emplace_back(i, i);
+            levels.back().second = i + 1;
+        }
+    }
+
 public:
-    void Update(ECSWorld& world, ShaderManager& shaderManager, const std::string& shaderName)
+    void Update(ECSWorld& world, ThreadPool& pool)
     {
-        shaderManager.Bind(shaderName);
-        
-        int lightIndex = 0;
-        const int maxLights = 8;
-        
-        world.Each<LightComponent, TransformComponent>(
-            [&](entt::entity entity, LightComponent& light, TransformComponent& transform)
+        auto& registry = world.GetRegistry();
+
+        if (world.ConsumeHierarchyChanged())
+            RebuildLevels(registry);
+
+        auto& transforms = registry.storage<TransformComponent>();
+        auto& worlds = registry.storage<WorldTransformComponent>();
+        auto& hierarchy = registry.storage<HierarchyComponent>();
+
+        std::atomic<size_t> updated{0};
+
+        const entt::entity* flat = worlds.data();
+        pool.ParallelFor(worlds.size(), chunkSize, [&](size_t begin, size_t end)
+        {
+            size_t count = 0;
+            for (size_t i = begin; i < end; i++)
             {
-                if (!light.isActive || lightIndex >= maxLights)
-                    return;
-                
-                light.SyncWithTransform(transform);
-                
-                std::string base = "lights[" + std::to_string(lightIndex) + "]";
-                
-                shaderManager.SetInt(shaderName, base + ".type", static_cast<int>(light.type));
-                
-                shaderManager.SetVec3(shaderName, base + ".position", light.position);
-                shaderManager.SetVec3(shaderName, base + ".direction", light.direction);
-                
-                shaderManager.SetVec3(shaderName, base + ".ambient", light.ambient * light.intensity);
-                shaderManager.SetVec3(shaderName, base + ".diffuse", light.diffuse * light.intensity);
-                shaderManager.SetVec3(shaderName, base + ".specular", light.specular);
-                
-                if (light.type == LightType::POINT || light.type == LightType::SPOT)
-                {
-                    shaderManager.SetFloat(shaderName, base + ".constant", light.constant);
-                    shaderManager.SetFloat(shaderName, base + ".linear", light.linear);
-                    shaderManager.SetFloat(shaderName, base + ".quadratic", light.quadratic);
-                }
-                
-                if (light.type == LightType::SPOT)
+                entt::entity entity = flat[i];
+                if (hierarchy.contains(entity))
+                    continue;
+
+                if (Refresh(transforms.get(entity), worlds.get(entity), entt::null, nullptr))
+                    count++;
+            }
+            updated.fetch_add(count, std::memory_order_relaxed);
+        });
+
+        const entt::entity* nodes = hierarchy.data();
+        for (const auto& [levelBegin, levelEnd] : levels)
+        {
+            pool.ParallelFor(levelEnd - levelBegin, chunkSize, [&](size_t begin, size_t end)
+            {
+                size_t count = 0;
+                for (size_t i = levelBegin + begin; i < levelBegin + end; i++)
                 {
-                    shaderManager.SetFloat(shaderName, base + ".innerCutoff", 
-                        glm::cos(glm::radians(light.innerCutoff)));
-                    shaderManager.SetFloat(shaderName, base + ".outerCutoff", 
-                        glm::cos(glm::radians(light.outerCutoff)));
+                    entt::entity entity = nodes[i];
+                    if (!worlds.contains(entity))
+                        continue;
+
+                    entt::entity parent = hierarchy.get(entity).parent;
+                    const WorldTransformComponent* parentWorld = 
+                        (parent != entt::null && worlds.contains(parent)) ? &worlds.get(parent) : nullptr;
+
+                    if (Refresh(transforms.get(entity), worlds.get(entity), parent, parentWorld))
+                        count++;
                 }
-                
-                lightIndex++;
+                updated.fetch_add(count, std::memory_order_relaxed);
             });
+        }
 
-        shaderManager.SetInt(shaderName, "numLights", lightIndex);
-        
-        shaderManager.Unbind();
+        lastUpdated = updated.load();
     }
-};
\ No newline at end of file
+
+    void SetChunkSize(size_t size) { chunkSize = size; }
+    size_t GetLastUpdatedCount() const { return lastUpdated; }
+};
+
+// Keeps the world's BVHs in step with entity bounds. Mesh bounds are only
+// re-transformed when the cached world matrix version moves; light spheres are
+// recomputed every frame since range depends on editable attenuation.
+export class SpatialSystem
+{
+private:
+    CullingStats stats;
+    std::vector<entt::entity> pending;
+
+    static uint32_t ToID(entt::entity entity) { return static_cast<uint32_t>(entt::to_integral(entity)); }
+
+public:
+    void Update(ECSWorld& world)
+    {
+        auto& registry = world.GetRegistry();
+        DynamicBVH& renderTree = world.GetRenderTree();
+        DynamicBVH& lightTree = world.GetLightTree();
+
+        auto start = std::chrono::steady_clock::now();
+        size_t reinserted = 0;
+
+        pending.clear();
+        for (auto entity : registry.view<WorldTransformComponent, MeshComponent>(entt::exclude<BoundsComponent>))
+            pending.push_back(entity);
+        for (auto entity : pending)
+            registry.emplace<BoundsComponent>(entity);
+
+        registry.view<BoundsComponent, WorldTransformComponent, MeshComponent>().each(
+            [&](entt::entity entity, BoundsComponent& bounds, WorldTransformComponent& transform, MeshComponent& meshComp)
+        {
+            if (!transform.initialized)
+                return;
+
+            const Mesh* mesh = meshComp.mesh.get();
+            bool stale = bounds.proxy == DynamicBVH::NULL_NODE || 
+                bounds.transformVersion != transform.version || bounds.source != mesh;
+            if (!stale)
+                return;
+
+            bounds.transformVersion = transform.version;
+            bounds.source = mesh;
+
+            if (!mesh || !mesh->GetBounds().IsValid())
+            {
+                renderTree.DestroyProxy(bounds.proxy);
+                bounds.proxy = DynamicBVH::NULL_NODE;
+                return;
+            }
+
+            bounds.world = mesh->GetBounds().Transformed(transform.world);
+
+            if (bounds.proxy == DynamicBVH::NULL_NODE)
+            {
+                bounds.proxy = renderTree.CreateProxy(bounds.world, ToID(entity));
+                reinserted++;
+            }
+            else if (renderTree.MoveProxy(bounds.proxy, bounds.world))
+                reinserted++;
+        });
+
+        // Directional lights affect everything and never enter the tree
+        pending.clear();
+        registry.view<LightComponent, WorldTransformComponent>().each(
+            [&](entt::entity entity, LightComponent& light, WorldTransformComponent& transform)
+        {
+            bool local = light.isActive && light.type != LightType::DIRECTIONAL;
+            auto* bounds = registry.try_get<LightBoundsComponent>(entity);
+
+            if (!local)
+            {
+                if (bounds)
+                    pending.push_back(entity);
+                return;
+            }
+
+            if (!bounds)
+                bounds = &registry.emplace<LightBoundsComponent>(entity);
+
+            bounds->center = transform.GetPosition();
+            bounds->radius = light.GetRange();
+
+            AABB box = AABB::FromSphere(bounds->center, bounds->radius);
+            if (bounds->proxy == DynamicBVH::NULL_NODE)
+                bounds->proxy = lightTree.CreateProxy(box, ToID(entity));
+            else
+                lightTree.MoveProxy(bounds->proxy, box);
+        });
+        for (auto entity : pending)
+            registry.remove<LightBoundsComponent>(entity);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        stats.updateMs = elapsed.count();
+        stats.reinserted = reinserted;
+        stats.proxies = renderTree.GetProxyCount();
+        stats.treeHeight = renderTree.GetHeight();
+    }
+
+    // Nearest visible mesh under the ray. The BVH narrows candidates by world
+    // bounds; each candidate is then tested against its object-space box.
+    entt::entity Pick(ECSWorld& world, const Ray& ray, float maxDistance = 1000.0f)
+    {
+        auto& registry = world.GetRegistry();
+        auto start = std::chrono::steady_clock::now();
+
+        entt::entity picked = entt::null;
+        world.GetRenderTree().RayCast(ray, maxDistance, [&](uint32_t id, float)
+        {
+            entt::entity entity = static_cast<entt::entity>(id);
+            if (!registry.all_of<WorldTransformComponent, MeshComponent>(entity))
+                return -1.0f;
+
+            if (auto* vis = registry.try_get<VisibilityComponent>(entity); vis && (!vis->isActive || !vis->visible))
+                return -1.0f;
+
+            const auto& transform = registry.get<WorldTransformComponent>(entity);
+            const auto& meshComp = registry.get<MeshComponent>(entity);
+            if (!meshComp.mesh)
+                return -1.0f;
+
+            // Same ray parameter in object space as long as the direction is not renormalized
+            glm::mat4 inverse = glm::inverse(transform.world);
+            Ray local{ glm::vec3(inverse * glm::vec4(ray.origin, 1.0f)), glm::vec3(inverse * glm::vec4(ray.direction, 0.0f)) };
+
+            float distance = local.Intersect(meshComp.mesh->GetBounds(), maxDistance);
+            if (distance >= 0.0f && distance < maxDistance)
+            {
+                picked = entity;
+                maxDistance = distance;
+            }
+            return distance;
+        });
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        stats.pickQueryMs = elapsed.count();
+
+        return picked;
+    }
+
+    CullingStats& GetStats() { return stats; }
+};
+
+// Uploads up to MAX_LIGHTS lights per frame. Directional lights always go first;
+// local lights are taken from the light BVH by frustum and ranked by their
+// attenuated intensity at the camera.
+export class LightSystem
+{
+private:
+    struct Candidate
+    {
+        float influence;
+        float viewDistance;     // tie-break between lights that reach the frustum equally
+        entt::entity entity;
+    };
+
+    LightsBlock block{};
+    std::vector<Candidate> candidates;
+
+    // Attenuated intensity where the light first reaches the view frustum, so a bright
+    // light beside visible geometry outranks a dim one next to the camera
+    static float Influence(const LightComponent& light, const Frustum& frustum)
+    {
+        float distance = frustum.DistanceOutside(light.position);
+        float attenuation = light.constant + light.linear * distance + light.quadratic * distance * distance;
+        return light.intensity / glm::max(attenuation, 1e-4f);
+    }
+
+public:
+    void Update(ECSWorld& world, ShaderManager& shaderManager, const Frustum& frustum, 
+                const glm::vec3& viewPos, CullingStats& culling)
+    {
+        auto& registry = world.GetRegistry();
+        candidates.clear();
+
+        registry.view<LightComponent>(entt::exclude<LightBoundsComponent>).each(
+            [&](entt::entity entity, LightComponent& light)
+            {
+                if (light.isActive && light.type == LightType::DIRECTIONAL)
+                    candidates.push_back({ std::numeric_limits<float>::max(), 0.0f, entity });
+            });
+
+        auto start = std::chrono::steady_clock::now();
+        size_t visibleLights = 0;
+
+        world.GetLightTree().QueryFrustum(frustum, [&](uint32_t id)
+        {
+            entt::entity entity = static_cast<entt::entity>(id);
+            const auto& bounds = registry.get<LightBoundsComponent>(entity);
+            if (!frustum.TestSphere(bounds.center, bounds.radius))
+                return;
+
+            auto& light = registry.get<LightComponent>(entity);
+            light.position = bounds.center;
+            candidates.push_back({ Influence(light, frustum), glm::length(light.position - viewPos), entity });
+            visibleLights++;
+        });
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        culling.lightQueryMs = elapsed.count();
+        culling.lightsVisible = visibleLights;
+        culling.lightsCulled = world.GetLightTree().GetProxyCount() - visibleLights;
+
+        size_t count = std::min<size_t>(candidates.size(), MAX_LIGHTS);
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+            [](const Candidate& a, const Candidate& b)
+            {
+                if (a.influence != b.influence)
+                    return a.influence > b.influence;
+                return a.viewDistance < b.viewDistance;
+            });
+
+        for (size_t i = 0; i < count; i++)
+        {
+            entt::entity entity = candidates[i].entity;
+            auto& light = registry.get<LightComponent>(entity);
+
+            if (auto* transform = registry.try_get<WorldTransformComponent>(entity))
+                light.SyncWithTransform(*transform);
+
+            GPULight& gpu = block.lights[i];
+
+            gpu.type = static_cast<int>(light.type);
+
+            gpu.position = light.position;
+            gpu.direction = light.direction;
+
+            gpu.ambient = light.ambient * light.intensity;
+            gpu.diffuse = light.diffuse * light.intensity;
+            gpu.specular = light.specular;
+
+            gpu.constant = light.constant;
+            gpu.linear = light.linear;
+            gpu.quadratic = light.quadratic;
+
+            gpu.innerCutoff = glm::cos(glm::radians(light.innerCutoff));
+            gpu.outerCutoff = glm::cos(glm::radians(light.outerCutoff));
+        }
+
+        block.numLights = static_cast<int>(count);
+        culling.lightsSelected = count;
+
+        shaderManager.UpdateLightsBlock(block);
+    }
+};
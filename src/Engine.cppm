@@ -15,6 +15,9 @@ module;
 // #include <unordered_map>
 #include <string>
 #include <variant>
+#include <vector>
+#include <filesystem>
+#include <algorithm>
 
 export module XEngine.Engine;
 
@@ -23,11 +26,19 @@ import XEngine.Application.Application;
 import XEngine.Core.Input;
 import XEngine.Core.CommandManager;
 import XEngine.Core.Logger;
+import XEngine.Core.ThreadPool;
+import XEngine.Core.Profiler;
 
+import XEngine.Rendering.Bounds;
 import XEngine.Rendering.Skybox;
 import XEngine.Rendering.Framebuffer;
 import XEngine.Rendering.Primitive.PrimitivesFactory;
 import XEngine.Rendering.Light;
+import XEngine.Rendering.RenderQueue;
+
+import XEngine.Resource.Shader.ShaderManager;
+import XEngine.Resource.Texture.TextureManager;
+import XEngine.Resource.Model.ModelManager;
 
 import XEngine.Scene.Mesh;
 import XEngine.Scene.Model;
@@ -38,6 +49,8 @@ import XEngine.ECS.ECSWorld;
 import XEngine.ECS.Components;
 import XEngine.ECS.Systems;
 
+import XEngine.Benchmark.Micro;
+
 export class Engine : public Application 
 {
 private:
@@ -47,8 +60,49 @@ private:
 
     std::unique_ptr<RenderSystem> renderSystem;
     std::unique_ptr<RotationSystem> rotationSystem;
+    std::unique_ptr<TransformSystem> transformSystem;
+    std::unique_ptr<SpatialSystem> spatialSystem;
     std::unique_ptr<LightSystem> lightSystem;
 
+    // Models requested through onLoadModel, spawned into the world once built
+    std::vector<std::pair<std::string, std::shared_ptr<Model>>> pendingModels;
+
+    void SpawnReadyModels()
+    {
+        for (auto it = pendingModels.begin(); it != pendingModels.end(); )
+        {
+            auto& [name, model] = *it;
+            if (!model->IsReady())
+            {
+                ++it;
+                continue;
+            }
+
+            if (model->GetMeshCount() == 0)
+            {
+                Logger::Log(LogLevel::WARNING, "Model has no meshes, nothing to spawn: " + name);
+                it = pendingModels.erase(it);
+                continue;
+            }
+
+            auto root = GetECSWorld()->CreateEntity(name);
+            GetECSWorld()->AddComponent<TransformComponent>(root);
+
+            for (size_t i = 0; i < model->GetMeshCount(); i++)
+            {
+                auto entity = GetECSWorld()->CreateEntity(name + " [" + std::to_string(i) + "]");
+                GetECSWorld()->AddComponent<TransformComponent>(entity);
+                GetECSWorld()->AddComponent<MeshComponent>(entity, std::make_shared<Mesh>(*model->GetMesh(i)));
+                GetECSWorld()->AddComponent<MaterialComponent>(entity, model->GetMesh(i)->GetMaterial());
+                GetECSWorld()->AddComponent<VisibilityComponent>(entity, true);
+                GetECSWorld()->SetParent(entity, root);
+            }
+
+            Logger::Log(LogLevel::INFO, "Model spawned: " + name + " (" + std::to_string(model->GetMeshCount()) + " meshes)");
+            it = pendingModels.erase(it);
+        }
+    }
+
 protected:
     void OnInitialize() override
     {
@@ -73,6 +127,8 @@ protected:
 
         renderSystem = std::make_unique<RenderSystem>();
         rotationSystem = std::make_unique<RotationSystem>();
+        transformSystem = std::make_unique<TransformSystem>();
+        spatialSystem = std::make_unique<SpatialSystem>();
         lightSystem = std::make_unique<LightSystem>();
 
         InitCommandRegistration();
@@ -85,6 +141,9 @@ protected:
         else
             Logger::Log(LogLevel::INFO, "EditorLayout created successfully!");
 
+        if (editorLayout && IsHeadless())
+            editorLayout->SetViewportSize(GetWindow()->GetWidth(), GetWindow()->GetHeight());
+
         GetShaderManager()->Bind("skybox");
         GetShaderManager()->SetInt("skybox", "skybox", 0);
         
@@ -93,8 +152,24 @@ protected:
 
     void OnUpdate(float deltaTime) override
     {
-        rotationSystem->Update(*GetECSWorld(), deltaTime);
-        lightSystem->Update(*GetECSWorld(), *GetShaderManager(), "basic");
+        if (!pendingModels.empty())
+        {
+            ProfileScope scope("Spawn models");
+            SpawnReadyModels();
+        }
+
+        {
+            ProfileScope scope("RotationSystem");
+            rotationSystem->Update(*GetECSWorld(), *GetThreadPool(), deltaTime);
+        }
+        {
+            ProfileScope scope("TransformSystem");
+            transformSystem->Update(*GetECSWorld(), *GetThreadPool());
+        }
+        {
+            ProfileScope scope("SpatialSystem");
+            spatialSystem->Update(*GetECSWorld());
+        }
     }
 
     void OnRender() override
@@ -118,30 +193,54 @@ protected:
                     0.1f, 100.0f
                 );
                 glm::mat4 view = GetCamera()->GetViewMatrix();
+                Frustum frustum(projection * view);
                 
-                GetShaderManager()->Bind("basic");
+                GetShaderManager()->UpdateCameraBlock(projection, view, GetCamera()->GetPosition());
+
+                glm::vec2 pickPoint;
+                if (editorLayout->ConsumePickRequest(pickPoint))
+                    PickEntity(pickPoint, projection, view);
+
+                CullingStats& culling = spatialSystem->GetStats();
+                {
+                    ProfileScope scope("LightSystem");
+                    lightSystem->Update(*GetECSWorld(), *GetShaderManager(), frustum, GetCamera()->GetPosition(), culling);
+                }
+                {
+                    ProfileScope scope("RenderSystem");
+                    GpuProfileScope gpuScope("Scene");
+                    renderSystem->Update(*GetECSWorld(), *GetShaderManager(), "basic", frustum, culling);
+                }
+
+                GetRenderer()->SetFrameStats(renderSystem->GetStats());
+                GetRenderer()->SetCullingStats(culling);
 
-                GLint currentProgram;
-                glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-                if (currentProgram != GetShaderManager()->GetShader("basic")->ID) 
-                    Logger::Log(LogLevel::ERROR, "Shader not active!");
-                
-                GetShaderManager()->SetMat4("basic", "projection", projection);
-                GetShaderManager()->SetMat4("basic", "view", view);
-                GetShaderManager()->SetVec3("basic", "viewPos", GetCamera()->GetPosition());
-                
                 static int frameCount = 0;
                 if (frameCount % 60 == 0) 
-                    Logger::Log(LogLevel::DEBUG, "Rendering " + 
-                        std::to_string(GetECSWorld()->GetEntityCount()) + " entities");
+                {
+                    const RenderStats& stats = renderSystem->GetStats();
+                    Logger::Log<LogLevel::DEBUG>(LogCategory::RENDERING, [&]()
+                    {
+                        return "Rendering " + 
+                            std::to_string(culling.visible) + " of " +
+                            std::to_string(culling.visible + culling.culled) + " meshes: " +
+                            std::to_string(stats.drawCalls) + " draw calls, " +
+                            std::to_string(stats.GetStateChanges()) + " state changes";
+                    });
+                }
                 frameCount++; 
-                
-                renderSystem->Update(*GetECSWorld(), *GetShaderManager(), "basic", *GetCamera());
-                skybox->Render(*GetShaderManager(), *GetCamera(), projection);
+
+                ProfileScope scope("Skybox");
+                GpuProfileScope gpuScope("Skybox");
+                skybox->Render(*GetShaderManager());
             }
             
             fb->Unbind();
         }
+
+        // No default framebuffer exists without a window
+        if (IsHeadless())
+            return;
         
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, GetWindow()->GetWidth(), GetWindow()->GetHeight());
@@ -154,7 +253,9 @@ protected:
     {
         Logger::Log(LogLevel::INFO, "Shutting down game...");
         
-        GetShaderManager()->ClearAll();
+        // Initialize may have failed before the managers were created
+        if (GetShaderManager())
+            GetShaderManager()->ClearAll();
         
         Logger::Log(LogLevel::INFO, "Game shutdown complete!");
     }
@@ -171,24 +272,49 @@ protected:
     }
 
 public:
-    Engine(int w, int h, const std::string& title)
-        : Application(w, h, title)
+    Engine(int w, int h, const std::string& title, bool headless = false)
+        : Application(w, h, title, headless)
     {}
 
+    bool HasPendingModels() const { return !pendingModels.empty(); }
+
 private:
+    void PickEntity(const glm::vec2& point, const glm::mat4& projection, const glm::mat4& view)
+    {
+        glm::vec2 ndc(point.x * 2.0f - 1.0f, 1.0f - point.y * 2.0f);
+        glm::mat4 inverse = glm::inverse(projection * view);
+
+        glm::vec4 nearPoint = inverse * glm::vec4(ndc, -1.0f, 1.0f);
+        glm::vec4 farPoint = inverse * glm::vec4(ndc, 1.0f, 1.0f);
+        nearPoint /= nearPoint.w;
+        farPoint /= farPoint.w;
+
+        Ray ray{ glm::vec3(nearPoint), glm::normalize(glm::vec3(farPoint - nearPoint)) };
+        entt::entity picked = spatialSystem->Pick(*GetECSWorld(), ray);
+
+        editorLayout->SetSelectedEntity(picked);
+
+        if (picked != entt::null && GetECSWorld()->HasComponent<TagComponent>(picked))
+            Logger::Log(LogLevel::DEBUG, "Picked " + GetECSWorld()->GetComponent<TagComponent>(picked).name);
+    }
+
     void InitCommandRegistration()
     {
+        // Optional arguments: position (vec3), material name (string)
         CommandManager::RegisterCommand("onCreateCube",
-        [this](const CommandArgs&) 
+        [this](const CommandArgs& args) 
         {
+            glm::vec3 position = args.size() >= 1 ? std::get<glm::vec3>(args[0]) : glm::vec3(0.0f);
+            std::string materialName = args.size() >= 2 ? std::get<std::string>(args[1]) : "gray";
+
             auto entity = GetECSWorld()->CreateEntity("Cube");
 
-            GetECSWorld()->AddComponent<TransformComponent>(entity, glm::vec3(0, 0, 0), glm::vec3(0), glm::vec3(1));
+            GetECSWorld()->AddComponent<TransformComponent>(entity, position, glm::vec3(0), glm::vec3(1));
 
             auto cubeMesh = PrimitivesFactory::CreatePrimitive(PrimitiveType::CUBE);
             GetECSWorld()->AddComponent<MeshComponent>(entity, cubeMesh);
 
-            auto material = GetMaterialManager()->GetMaterial("gray");
+            auto material = GetMaterialManager()->GetMaterial(materialName);
             GetECSWorld()->AddComponent<MaterialComponent>(entity, material);
 
             GetECSWorld()->AddComponent<ColorComponent>(entity, glm::vec3(0.5f, 0.5f, 0.5f));
@@ -198,6 +324,21 @@ private:
             Logger::Log(LogLevel::INFO, "Cube entity created");
         });
 
+        CommandManager::RegisterCommand("onLoadModel",
+        [this](const CommandArgs& args) 
+        {
+            if (args.size() != 1)
+            {
+                Logger::Log(LogLevel::ERROR, "onLoadModel requires 1 argument: path");
+                return;
+            }
+
+            const auto& path = std::get<std::string>(args[0]);
+            std::string name = std::filesystem::path(path).stem().string();
+
+            pendingModels.emplace_back(name, GetModelManager()->LoadModel(path));
+        });
+
         CommandManager::RegisterCommand("onExit",
         [this](const CommandArgs&) 
         {
@@ -242,6 +383,53 @@ private:
             }
         });
 
+        CommandManager::RegisterCommand("onBenchmarkUniforms",
+        [this](const CommandArgs& args) 
+        {
+            MicroBenchmarks::Uniforms(*GetShaderManager(), (args.size() == 1) ? std::get<int>(args[0]) : 1000);
+        });
+
+        CommandManager::RegisterCommand("onBenchmarkTransforms",
+        [](const CommandArgs& args) 
+        {
+            MicroBenchmarks::Transforms((args.size() == 1) ? std::get<int>(args[0]) : 60);
+        });
+
+        CommandManager::RegisterCommand("onBenchmarkLoading",
+        [this](const CommandArgs&) 
+        {
+            MicroBenchmarks::TextureLoading(GetLoadPool());
+        });
+
+        CommandManager::RegisterCommand("onReportTextures",
+        [this](const CommandArgs&) 
+        {
+            auto infos = GetTextureManager()->GetTextureInfo();
+            std::sort(infos.begin(), infos.end(), [](const TextureInfo& a, const TextureInfo& b) { return a.vramBytes > b.vramBytes; });
+
+            for (const auto& info : infos)
+                Logger::Log(LogLevel::INFO, info.path + ": " + std::to_string(info.width) + "x" + std::to_string(info.height) +
+                    " " + info.format + ", " + std::to_string(info.levels) + " levels, " + std::to_string(info.vramBytes / 1024) +
+                    " KiB, " + std::to_string(info.loadMs) + " ms" + (info.fromCache ? " (cached)" : ""));
+
+            const TextureLoadStats stats = GetTextureManager()->GetStats();
+            Logger::Log(LogLevel::INFO, "Textures: " + std::to_string(infos.size()) + " resident, " +
+                std::to_string(stats.vramBytes / 1024) + " KiB VRAM, " + std::to_string(stats.cacheHits) + " cache hits, " +
+                std::to_string(stats.cacheMisses) + " cooked");
+        });
+
+        CommandManager::RegisterCommand("onBenchmarkMeshes",
+        [](const CommandArgs&) 
+        {
+            MicroBenchmarks::Meshes();
+        });
+
+        CommandManager::RegisterCommand("onBenchmarkLogging",
+        [](const CommandArgs&) 
+        {
+            MicroBenchmarks::Logging();
+        });
+
         CommandManager::RegisterCommand("onCreateDirectionalLight",
         [this](const CommandArgs&) 
         {
@@ -258,13 +446,16 @@ private:
             Logger::Log(LogLevel::INFO, "Directional light created");
         });
 
+        // Optional argument: position (vec3)
         CommandManager::RegisterCommand("onCreatePointLight",
-        [this](const CommandArgs&) 
+        [this](const CommandArgs& args) 
         {
+            glm::vec3 position = args.size() >= 1 ? std::get<glm::vec3>(args[0]) : glm::vec3(0, 5, 0);
+
             auto entity = GetECSWorld()->CreateEntity("Point Light");
             
             GetECSWorld()->AddComponent<TransformComponent>(entity, 
-                glm::vec3(0, 5, 0), 
+                position, 
                 glm::vec3(0), 
                 glm::vec3(1));
             
@@ -274,13 +465,16 @@ private:
             Logger::Log(LogLevel::INFO, "Point light created");
         });
 
+        // Optional argument: position (vec3)
         CommandManager::RegisterCommand("onCreateSpotLight",
-        [this](const CommandArgs&) 
+        [this](const CommandArgs& args) 
         {
+            glm::vec3 position = args.size() >= 1 ? std::get<glm::vec3>(args[0]) : glm::vec3(0, 5, 0);
+
             auto entity = GetECSWorld()->CreateEntity("Spot Light");
             
             GetECSWorld()->AddComponent<TransformComponent>(entity, 
-                glm::vec3(0, 5, 0), 
+                position, 
                 glm::vec3(45, 0, 0), 
                 glm::vec3(1));
             
@@ -8,6 +8,7 @@ module;
 #include <cstring>
 #include <memory>
 #include <unordered_map>
+#include <algorithm>
 
 export module XEngine.UI.EditorLayout;
 
@@ -17,10 +18,12 @@ import XEngine.ECS.Components;
 import XEngine.Core.Camera;
 import XEngine.Core.Logger;
 import XEngine.Core.CommandManager;
+import XEngine.Core.Profiler;
 
 import XEngine.Rendering.Renderer;
 import XEngine.Rendering.Framebuffer;
 import XEngine.Rendering.Light;
+import XEngine.Rendering.RenderQueue;
 
 import XEngine.Resource.Material.MaterialManager;
 
@@ -39,6 +42,7 @@ public:
         , showInspector(true)
         , showProperties(true)
         , showConsole(false)
+        , showProfiler(false)
         , viewportSize({800, 600})
         , viewportPos({0, 0})
         , isViewportHovered(false)
@@ -121,12 +125,42 @@ public:
                 ImGui::EndMenu();
             }
 
+            if (ImGui::BeginMenu("Tools"))
+            {
+                if (ImGui::MenuItem("Benchmark Uniforms"))
+                    if(CommandManager::HasCommand("onBenchmarkUniforms")) 
+                        CommandManager::ExecuteCommand("onBenchmarkUniforms", {});
+
+                if (ImGui::MenuItem("Benchmark Transforms"))
+                    if(CommandManager::HasCommand("onBenchmarkTransforms")) 
+                        CommandManager::ExecuteCommand("onBenchmarkTransforms", {});
+
+                if (ImGui::MenuItem("Benchmark Texture Loading"))
+                    if(CommandManager::HasCommand("onBenchmarkLoading")) 
+                        CommandManager::ExecuteCommand("onBenchmarkLoading", {});
+
+                if (ImGui::MenuItem("Benchmark Mesh Loading"))
+                    if(CommandManager::HasCommand("onBenchmarkMeshes")) 
+                        CommandManager::ExecuteCommand("onBenchmarkMeshes", {});
+
+                if (ImGui::MenuItem("Benchmark Logging"))
+                    if(CommandManager::HasCommand("onBenchmarkLogging")) 
+                        CommandManager::ExecuteCommand("onBenchmarkLogging", {});
+
+                if (ImGui::MenuItem("Texture Report"))
+                    if(CommandManager::HasCommand("onReportTextures")) 
+                        CommandManager::ExecuteCommand("onReportTextures", {});
+                    
+                ImGui::EndMenu();
+            }
+
             if (ImGui::BeginMenu("View"))
             {
                 ImGui::MenuItem("Hierarchy", nullptr, &showHierarchy);
                 ImGui::MenuItem("Inspector", nullptr, &showInspector);
                 ImGui::MenuItem("Properties", nullptr, &showProperties);
                 ImGui::MenuItem("Console", nullptr, &showConsole);
+                ImGui::MenuItem("Profiler", nullptr, &showProfiler);
                 
                 ImGui::Separator();
                 
@@ -178,15 +212,34 @@ public:
         if (showInspector)  RenderInspector(ecs, shaderManager, materialManager);
         if (showProperties) RenderProperties(camera, renderer);
         if (showConsole)    RenderConsole();
+        if (showProfiler)   RenderProfiler();
         
         RenderViewport();
     }
 
+    // Headless runs have no viewport window to size the framebuffer from
+    void SetViewportSize(int width, int height)
+    {
+        viewportSize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+        framebuffer->Resize(width, height);
+    }
+
     ImVec2 GetViewportSize()  const { return viewportSize; }
     ImVec2 GetViewportPos()   const { return viewportPos; }
     bool   IsViewportHovered() const { return isViewportHovered; }
     bool   IsViewportFocused() const { return isViewportFocused; }
 
+    // Normalized [0, 1] viewport position of the last left click, top-left origin
+    bool ConsumePickRequest(glm::vec2& point)
+    {
+        if (!pickRequested)
+            return false;
+
+        point = pickPoint;
+        pickRequested = false;
+        return true;
+    }
+
     entt::entity GetSelectedEntity() const { return selectedEntity; }
     ShaderObj* GetSelectedShader() const { return selectedShader; }
     Framebuffer* GetFramebuffer() const { return framebuffer.get(); }
@@ -203,12 +256,18 @@ private:
     bool showInspector;
     bool showProperties;
     bool showConsole;
+    bool showProfiler;
+
+    int captureFrames = 120;
 
     ImVec2 viewportSize;
     ImVec2 viewportPos;
     bool   isViewportHovered;
     bool   isViewportFocused;
 
+    bool      pickRequested = false;
+    glm::vec2 pickPoint{0.0f};
+
     std::unique_ptr<Framebuffer> framebuffer;
 
     // ───── UI blocks ─────
@@ -247,6 +306,13 @@ private:
                 size,
                 {0, 1},
                 {1, 0});
+
+            if (ImGui::IsItemClicked(ImGuiMouseButton_Left) && size.x > 0 && size.y > 0)
+            {
+                ImVec2 mouse = ImGui::GetMousePos();
+                pickPoint = { (mouse.x - viewportPos.x) / size.x, (mouse.y - viewportPos.y) / size.y };
+                pickRequested = true;
+            }
         }
         else
         {
@@ -438,6 +504,34 @@ private:
                 if (ImGui::CollapsingHeader("Transform", ImGuiTreeNodeFlags_DefaultOpen))
                 {
                     auto& transform = ecs->GetComponent<TransformComponent>(selectedEntity);
+
+                    entt::entity parent = ecs->GetParent(selectedEntity);
+                    std::string parentName = (parent != entt::null && ecs->HasComponent<TagComponent>(parent)) 
+                        ? ecs->GetComponent<TagComponent>(parent).name : "None";
+
+                    ImGui::Text("Parent");
+                    if (ImGui::BeginCombo("##Parent", parentName.c_str()))
+                    {
+                        if (ImGui::Selectable("None", parent == entt::null))
+                            ecs->SetParent(selectedEntity, entt::null);
+
+                        ecs->Each<TagComponent, TransformComponent>(
+                            [&](entt::entity entity, TagComponent& tag, TransformComponent&) 
+                        {
+                            if (entity == selectedEntity)
+                                return;
+
+                            ImGui::PushID((int)entt::to_integral(entity));
+                            if (ImGui::Selectable(tag.name.c_str(), entity == parent))
+                                ecs->SetParent(selectedEntity, entity);
+                            ImGui::PopID();
+                        });
+
+                        ImGui::EndCombo();
+                    }
+
+                    ImGui::Spacing();
+                    ImGui::Separator();
                     
                     ImGui::Text("Position");
                     ImGui::DragFloat3("##Pos", &transform.position[0], 0.1f);
@@ -726,6 +820,29 @@ private:
             ImGui::Checkbox("Wireframe", &s.enableWireframe);
             ImGui::Checkbox("Depth Test", &s.enableDepthTest);
             ImGui::ColorEdit3("Clear", &s.clearColor[0]);
+
+            ImGui::Spacing();
+            ImGui::Separator();
+
+            const RenderStats& stats = renderer->GetFrameStats();
+            ImGui::Text("Submitted: %zu", stats.submitted);
+            ImGui::Text("Draw calls: %zu (%zu instances)", stats.drawCalls, stats.instances);
+            ImGui::Text("Triangles: %zu", stats.triangles);
+            ImGui::Text("State changes: %zu", stats.GetStateChanges());
+            ImGui::BulletText("Shader: %zu  Material: %zu  Mesh: %zu", 
+                stats.shaderBinds, stats.materialBinds, stats.meshBinds);
+
+            ImGui::Spacing();
+            ImGui::Separator();
+
+            const CullingStats& culling = renderer->GetCullingStats();
+            ImGui::Text("Visible: %zu  Culled: %zu", culling.visible, culling.culled);
+            ImGui::Text("Lights: %zu selected, %zu visible, %zu culled", 
+                culling.lightsSelected, culling.lightsVisible, culling.lightsCulled);
+            ImGui::Text("BVH: %zu proxies, height %d, %zu reinserted", 
+                culling.proxies, culling.treeHeight, culling.reinserted);
+            ImGui::BulletText("Update: %.3f ms  Frustum: %.3f ms", culling.updateMs, culling.frustumQueryMs);
+            ImGui::BulletText("Lights: %.3f ms  Pick: %.3f ms", culling.lightQueryMs, culling.pickQueryMs);
         }
 
         ImGui::End();
@@ -740,4 +857,90 @@ private:
         ImGui::Text("[INFO] Editor ready with ECS");
         ImGui::End();
     }
+
+    void RenderProfiler()
+    {
+        ImGui::SetNextWindowPos({300, 380}, ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowSize({420, 460}, ImGuiCond_FirstUseEver);
+
+        ImGui::Begin("Profiler", &showProfiler);
+
+        bool enabled = Profiler::IsEnabled();
+        if (ImGui::Checkbox("Enabled", &enabled))
+            Profiler::SetEnabled(enabled);
+
+        const auto& history = Profiler::GetHistory();
+        float cpuMax = 0.0f, cpuSum = 0.0f, gpuLast = 0.0f;
+        size_t samples = 0;
+        for (const FrameSample& sample : history)
+        {
+            if (sample.cpuMs <= 0.0)
+                continue;
+            cpuMax = std::max(cpuMax, static_cast<float>(sample.cpuMs));
+            cpuSum += static_cast<float>(sample.cpuMs);
+            samples++;
+        }
+        for (const GpuProfileEvent& event : Profiler::GetLastGpuEvents())
+            gpuLast += static_cast<float>(event.durationMs);
+
+        const FrameSample& last = Profiler::GetLastFrame();
+        ImGui::Text("CPU: %.2f ms (avg %.2f, max %.2f)", last.cpuMs, samples ? cpuSum / samples : 0.0f, cpuMax);
+        ImGui::Text("GPU: %.2f ms (%llu frames without free queries)", gpuLast,
+            static_cast<unsigned long long>(Profiler::GetSkippedGpuFrames()));
+
+        float scale = std::max(cpuMax, 1000.0f / 60.0f);
+        int offset = Profiler::GetHistoryOffset();
+        int count = static_cast<int>(Profiler::HISTORY_SIZE);
+        ImGui::PlotLines("CPU", Profiler::GetCpuTimes(), count, offset, nullptr, 0.0f, scale, ImVec2(0, 60));
+        ImGui::PlotLines("GPU", Profiler::GetGpuTimes(), count, offset, nullptr, 0.0f, scale, ImVec2(0, 60));
+
+        if (ImGui::CollapsingHeader("Counters", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            for (size_t i = 0; i < PROFILE_COUNTER_COUNT; i++)
+                ImGui::Text("%s: %llu", GetCounterName(static_cast<ProfileCounter>(i)),
+                    static_cast<unsigned long long>(last.counters[i]));
+        }
+
+        if (ImGui::CollapsingHeader("CPU Scopes", ImGuiTreeNodeFlags_DefaultOpen) &&
+            ImGui::BeginTable("ProfilerScopes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+        {
+            ImGui::TableSetupColumn("Scope");
+            ImGui::TableSetupColumn("Last ms");
+            ImGui::TableSetupColumn("Avg ms");
+            ImGui::TableHeadersRow();
+
+            for (const ScopeSummary& scope : Profiler::GetScopeSummaries())
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%*s%s", static_cast<int>(scope.depth * 2), "", scope.name);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", scope.lastMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", scope.averageMs);
+            }
+
+            ImGui::EndTable();
+        }
+
+        if (ImGui::CollapsingHeader("GPU Scopes", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            for (const GpuProfileEvent& event : Profiler::GetLastGpuEvents())
+                ImGui::Text("%s: %.3f ms", event.name, event.durationMs);
+        }
+
+        ImGui::Separator();
+        ImGui::SetNextItemWidth(100.0f);
+        ImGui::InputInt("Frames", &captureFrames);
+        captureFrames = std::clamp(captureFrames, 1, 10000);
+        ImGui::SameLine();
+
+        bool capturing = Profiler::IsCapturing();
+        ImGui::BeginDisabled(capturing);
+        if (ImGui::Button(capturing ? "Capturing..." : "Capture Trace"))
+            Profiler::RequestCapture(captureFrames);
+        ImGui::EndDisabled();
+
+        ImGui::End();
+    }
 };
\ No newline at end of file
@@ -4,8 +4,12 @@ module;
 #include <glm/glm.hpp>
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
 #include <memory>
 #include <utility>
+#include <chrono>
+#include <cstdlib>
+#include <string>
 
 export module XEngine.Application.Application;
 
@@ -16,12 +20,15 @@ import XEngine.Core.Camera;
 import XEngine.Core.Logger;
 import XEngine.Core.Logging.ConsoleLogger;
 import XEngine.Core.Logging.FileLogger;
+import XEngine.Core.ThreadPool;
+import XEngine.Core.Profiler;
 
 import XEngine.ECS.ECSWorld;
 
 import XEngine.Rendering.Renderer; 
 
 import XEngine.Resource.Texture.TextureManager;
+import XEngine.Resource.Model.ModelManager;
 import XEngine.Resource.Material.MaterialManager;
 import XEngine.Resource.Shader.ShaderManager;
 
@@ -36,19 +43,33 @@ private:
     std::unique_ptr<Camera> camera;
     std::unique_ptr<Renderer> renderer;
     std::unique_ptr<TextureManager> textureManager;
+    std::unique_ptr<ModelManager> modelManager;
     std::unique_ptr<ImGuiManager> imGuiManager;
     std::unique_ptr<MaterialManager> materialManager;
     std::unique_ptr<ECSWorld> ecsWorld;
     std::unique_ptr<ShaderManager> shaderManager;
+    std::unique_ptr<ThreadPool> threadPool;     // frame work (ParallelFor)
+    std::unique_ptr<ThreadPool> loadPool;       // texture decodes and model imports
     
     ConsoleLogger console;
     FileLogger file;
 
     bool isRunning;
     bool showUI;
+    bool shutDown = false;
+
+    // GPU uploads of streamed resources allowed per frame
+    double uploadBudgetMs = 2.0;
+
+    std::chrono::steady_clock::time_point startTime;
+    double startupMs = 0.0;
+    bool residentReported = false;
     
     void ProcessInput()
     {
+        if (window->IsHeadless())
+            return;
+
         if (input->IsKeyPressed(XKey::KEY_ESCAPE)) 
             Stop();
         
@@ -83,15 +104,53 @@ private:
     {
         float deltaTime = time->GetDeltaTime();
         
+        ProfileScope scope("OnUpdate");
         OnUpdate(deltaTime);
     }
 
+    void ProcessResourceUploads()
+    {
+        ProfileScope scope("Resource uploads");
+        textureManager->ProcessUploads(uploadBudgetMs);
+        modelManager->ProcessUploads(uploadBudgetMs);
+
+        if (!residentReported && textureManager->GetPendingCount() == 0 && modelManager->GetPendingCount() == 0)
+        {
+            residentReported = true;
+            ReportColdStart();
+        }
+    }
+
+    void ReportColdStart()
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+        TextureLoadStats textures = textureManager->GetStats();
+        const ModelLoadStats& models = modelManager->GetStats();
+
+        Logger::Log(LogLevel::INFO, LogCategory::CORE, 
+            std::string("Cold start (") + (textureManager->IsAsyncLoading() ? "async" : "serial") + "): " +
+            "all resources resident after " + std::to_string(elapsed.count()) + " ms; " +
+            std::to_string(textures.uploaded) + " textures (" + std::to_string(textures.decoded) + " images decoded in " +
+            std::to_string(textures.decodeMs) + " ms, uploaded in " + std::to_string(textures.uploadMs) + " ms, " +
+            std::to_string(textures.deduplicated) + " deduplicated, " + std::to_string(textures.failed) + " failed), " +
+            std::to_string(models.built) + " models (import " + std::to_string(models.importMs) + 
+            " ms, build " + std::to_string(models.buildMs) + " ms)");
+    }
+
     void Render()
     {
-        OnRender();  
+        ProcessResourceUploads();
+
+        {
+            ProfileScope scope("OnRender");
+            OnRender();
+        }
 
         if (showUI) 
         {
+            ProfileScope scope("ImGui");
+            GpuProfileScope gpuScope("ImGui");
+
             int width = window->GetWidth();
             int height = window->GetHeight();
             glViewport(0, 0, width, height);
@@ -143,12 +202,13 @@ private:
 protected:
     bool cameraControlEnabled;
 
-    Application(int width, int height, const std::string& title)
+    // A headless application renders offscreen without a window, input or UI
+    Application(int width, int height, const std::string& title, bool headless = false)
         : window(nullptr), input(nullptr), time(nullptr), camera(nullptr),
             renderer(nullptr), textureManager(nullptr), isRunning(false), 
-            showUI(true), cameraControlEnabled(false)
+            showUI(!headless), cameraControlEnabled(false)
     {
-        window = std::make_unique<Window>(width, height, title);
+        window = std::make_unique<Window>(width, height, title, headless);
 
         Logger::Log(LogLevel::INFO, "Application created");
     }
@@ -176,6 +236,7 @@ protected:
     }
 
 public:
+    // Call Shutdown explicitly; from here OnShutdown no longer reaches the derived class
     virtual ~Application()
     {
         Shutdown();
@@ -188,46 +249,72 @@ public:
     
     bool Initialize()
     {
+        startTime = std::chrono::steady_clock::now();
+
+        // Before the window, so context creation failures are reported
+        Logger::AddSink(&console);
+        Logger::AddSink(&file);
+
         if (!window->Initialize())
         {
             Logger::Log(LogLevel::ERROR, "Failed to initialize Window");
             return false;
         }
 
-        glfwSetWindowUserPointer(window->GetGLFWWindow(), this);
-        
-        window->SetFramebufferSizeCallback(FramebufferSizeCallback);
-        window->SetCursorPosCallback(MouseCallback);
-        window->SetScrollCallback(Input::ScrollCallback);
-        window->SetMouseButtonCallback(MouseButtonCallback);
+        if (!window->IsHeadless())
+        {
+            glfwSetWindowUserPointer(window->GetGLFWWindow(), this);
+            
+            window->SetFramebufferSizeCallback(FramebufferSizeCallback);
+            window->SetCursorPosCallback(MouseCallback);
+            window->SetScrollCallback(Input::ScrollCallback);
+            window->SetMouseButtonCallback(MouseButtonCallback);
+        }
         
         input = std::make_unique<Input>(window->GetGLFWWindow());
         time = std::make_unique<Time>();
         camera = std::make_unique<Camera>(glm::vec3(0.0f, 0.0f, 0.0f));
         renderer = std::make_unique<Renderer>();
-        textureManager = std::make_unique<TextureManager>();
+        // Loads get their own workers so multi-millisecond jobs never queue ahead of frame work
+        threadPool = std::make_unique<ThreadPool>();
+        loadPool = std::make_unique<ThreadPool>(std::max<size_t>(1, ThreadPool::DefaultThreadCount() / 2));
+        textureManager = std::make_unique<TextureManager>(loadPool.get());
+        modelManager = std::make_unique<ModelManager>(textureManager.get(), loadPool.get());
         imGuiManager = std::make_unique<ImGuiManager>();
         materialManager = std::make_unique<MaterialManager>(textureManager.get());
         ecsWorld = std::make_unique<ECSWorld>();
         shaderManager = std::make_unique<ShaderManager>();
+
+        // Serial loading, for comparing cold-start times against the async path
+        if (std::getenv("XENGINE_SERIAL_LOADING"))
+        {
+            textureManager->SetAsyncLoading(false);
+            modelManager->SetAsyncLoading(false);
+        }
         
         renderer->Initialize();
         
         glEnable(GL_DEBUG_OUTPUT);
         glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
-        imGuiManager = std::make_unique<ImGuiManager>();
-        if (!imGuiManager->Initialize(window->GetGLFWWindow())) 
-            return false;
+        if (!window->IsHeadless())
+        {
+            imGuiManager = std::make_unique<ImGuiManager>();
+            if (!imGuiManager->Initialize(window->GetGLFWWindow())) 
+                return false;
 
-        SetCameraControlMode(false);  
+            SetCameraControlMode(false);  
+        }
         
-        Logger::AddSink(&console);
-        Logger::AddSink(&file);
+        // Sinks run on a background thread; XENGINE_SYNC_LOGGING writes on the caller instead
+        if (!std::getenv("XENGINE_SYNC_LOGGING"))
+            Logger::StartAsync();
         
         OnInitialize();
 
-        Logger::Log(LogLevel::INFO, "Application initialized successfully");
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+        startupMs = elapsed.count();
+        Logger::Log(LogLevel::INFO, "Application initialized successfully in " + std::to_string(startupMs) + " ms");
         
         return true;
     }
@@ -237,20 +324,38 @@ public:
         isRunning = true;
         
         while (isRunning && !window->ShouldClose())
+            RunFrame();
+    }
+
+    void RunFrame()
+    {
+        Profiler::BeginFrame();
+        time->Update();
+        
         {
-            time->Update();
-            
+            ProfileScope scope("Input");
             ProcessInput();
-            Update();
-            Render();
-            
+        }
+        Update();
+        Render();
+        
+        {
+            ProfileScope scope("Swap");
             window->SwapBuffers();
+        }
+        {
+            ProfileScope scope("Poll events");
             window->PollEvents();
         }
+        Profiler::EndFrame();
     }
 
     void Shutdown()
     {
+        if (shutDown)
+            return;
+        shutDown = true;
+
         OnShutdown();
 
         if (imGuiManager)
@@ -259,7 +364,20 @@ public:
             imGuiManager.reset();
         }        
 
+        Profiler::Shutdown();
+
+        // Pending imports and decodes log through the sinks, so skip what is
+        // still queued and join the workers before the sinks go away
+        if (loadPool)
+        {
+            loadPool->CancelPending();
+            loadPool.reset();
+        }
+        threadPool.reset();
+
+        Logger::StopAsync();
         Logger::RemoveSink(&console);
+        Logger::RemoveSink(&file);
         
         Logger::Log(LogLevel::INFO, "Application shutdown complete");
     }
@@ -269,14 +387,25 @@ public:
         isRunning = false; 
     }
     
+    bool IsHeadless() const { return window->IsHeadless(); }
+    double GetStartupMs() const { return startupMs; }
+
+    bool AreResourcesResident() const
+    {
+        return textureManager->GetPendingCount() == 0 && modelManager->GetPendingCount() == 0;
+    }
+
     Window* GetWindow() const { return window.get(); }
     Input* GetInput() const { return input.get(); }
     Time* GetTime() const { return time.get(); }
     Camera* GetCamera() const { return camera.get(); }
     Renderer* GetRenderer() const { return renderer.get(); }
     TextureManager* GetTextureManager() const { return textureManager.get(); }
+    ModelManager* GetModelManager() const { return modelManager.get(); }
     ImGuiManager* GetImGuiManager() const { return imGuiManager.get(); }
     MaterialManager* GetMaterialManager() const { return materialManager.get(); }
     ECSWorld* GetECSWorld() const { return ecsWorld.get(); }
     ShaderManager* GetShaderManager() const { return shaderManager.get(); }
+    ThreadPool* GetThreadPool() const { return threadPool.get(); }
+    ThreadPool* GetLoadPool() const { return loadPool.get(); }
 };
\ No newline at end of file
@@ -0,0 +1,434 @@
+module;
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+export module XEngine.Benchmark;
+
+import XEngine.Engine;
+import XEngine.Benchmark.Stats;
+
+import XEngine.Core.Camera;
+import XEngine.Core.CommandManager;
+import XEngine.Core.Logger;
+import XEngine.Core.Logging.ConsoleLogger;
+import XEngine.Core.Profiler;
+import XEngine.Core.Time;
+
+import XEngine.Scene.Model;
+
+using json = nlohmann::ordered_json;
+
+export struct BenchmarkConfig
+{
+    std::string scene = "medium";
+    int cubes = 1000;
+    int pointLights = 8;
+    int spotLights = 4;
+    bool textured = false;
+    bool models = false;            // every model file under assets/objects
+    int width = 1280;
+    int height = 720;
+    int warmupFrames = 60;
+    int frames = 600;
+    float fixedDeltaTime = 1.0f / 60.0f;
+    std::string output = "benchmark.json";
+    bool verbose = false;
+};
+
+// Headless, fixed-timestep run of a generated scene. The scene is built through the
+// same CommandManager commands the editor menus use; results are written as JSON
+// with a fixed key order and rounding so runs on one machine can be diffed.
+export class Benchmark
+{
+private:
+    struct ScopeSeries
+    {
+        std::string path;           // parent scopes joined with '/'
+        std::vector<double> ms;     // one entry per measured frame
+    };
+
+    static constexpr int MAX_LOAD_FRAMES = 20000;
+
+    static bool ApplyPreset(BenchmarkConfig& config, const std::string& name)
+    {
+        struct Preset { const char* name; int cubes; int pointLights; int spotLights; bool textured; bool models; };
+        static constexpr Preset presets[] = {
+            { "small",    100,   4,  2, false, false },
+            { "medium",   1000,  8,  4, false, false },
+            { "large",    10000, 16, 8, false, false },
+            { "textured", 1000,  8,  4, true,  false },
+            { "models",   100,   4,  2, true,  true  },
+        };
+
+        for (const Preset& preset : presets)
+        {
+            if (name == preset.name)
+            {
+                config.scene = preset.name;
+                config.cubes = preset.cubes;
+                config.pointLights = preset.pointLights;
+                config.spotLights = preset.spotLights;
+                config.textured = preset.textured;
+                config.models = preset.models;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void BuildScene(Engine& engine, const BenchmarkConfig& config, const std::vector<std::string>& models)
+    {
+        static const std::string flatMaterials[] = { "default_white", "red_material", "blue_material", "green_material" };
+        static const std::string texturedMaterials[] = { "bricks", "rust_metal" };
+
+        const float spacing = 3.0f;
+        const int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(config.cubes)))));
+        const float extent = side * spacing;
+        const float half = (side - 1) * spacing * 0.5f;
+
+        for (int i = 0; i < config.cubes; i++)
+        {
+            glm::vec3 position((i % side) * spacing - half, 0.0f, (i / side) * spacing - half);
+            const std::string& material = config.textured ? texturedMaterials[i % 2] : flatMaterials[i % 4];
+            CommandManager::ExecuteCommand("onCreateCube", { position, material });
+        }
+
+        CommandManager::ExecuteCommand("onCreateDirectionalLight", {});
+
+        auto ring = [&](const char* command, int count, float radius, float height, float phase)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                float angle = phase + 6.2831853f * i / count;
+                CommandManager::ExecuteCommand(command, { glm::vec3(std::cos(angle) * radius, height, std::sin(angle) * radius) });
+            }
+        };
+        ring("onCreatePointLight", config.pointLights, extent * 0.35f, 4.0f, 0.0f);
+        ring("onCreateSpotLight", config.spotLights, extent * 0.25f, 8.0f, 0.5f);
+
+        for (const auto& path : models)
+            CommandManager::ExecuteCommand("onLoadModel", { path });
+
+        Camera* camera = engine.GetCamera();
+        camera->SetPosition(glm::vec3(0.0f, extent * 0.4f + 6.0f, extent * 0.6f + 12.0f));
+        camera->SetYaw(-90.0f);
+        camera->SetPitch(-30.0f);
+    }
+
+    // Microsecond resolution; finer digits are noise and only make diffs longer
+    static double Round(double value)
+    {
+        return std::round(value * 1000.0) / 1000.0;
+    }
+
+    static json ToJson(const SampleSummary& summary)
+    {
+        json result;
+        result["meanMs"] = Round(summary.mean);
+        result["p50Ms"] = Round(summary.p50);
+        result["p95Ms"] = Round(summary.p95);
+        result["p99Ms"] = Round(summary.p99);
+        result["maxMs"] = Round(summary.max);
+        return result;
+    }
+
+    // Adds the last frame's CPU scopes, merging repeated scopes within the frame
+    static void RecordScopes(std::vector<ScopeSeries>& series, size_t frame)
+    {
+        std::string stack[Profiler::MAX_SCOPE_DEPTH];
+        for (const ProfileEvent& event : Profiler::GetLastEvents())
+        {
+            stack[event.depth] = event.depth == 0 ? std::string(event.name) : stack[event.depth - 1] + "/" + event.name;
+            const std::string& path = stack[event.depth];
+
+            auto it = std::find_if(series.begin(), series.end(), [&](const ScopeSeries& s) { return s.path == path; });
+            if (it == series.end())
+            {
+                series.push_back({ path, {} });
+                it = series.end() - 1;
+            }
+
+            it->ms.resize(frame + 1, 0.0);
+            it->ms[frame] += event.durationMs;
+        }
+    }
+
+    // Headless frames end in glFinish inside the "Swap" scope, so that scope is the
+    // time spent waiting for the GPU rather than CPU work
+    static double GetSwapMs()
+    {
+        double ms = 0.0;
+        for (const ProfileEvent& event : Profiler::GetLastEvents())
+            if (event.depth == 0 && std::string_view(event.name) == "Swap")
+                ms += event.durationMs;
+        return ms;
+    }
+
+    static uint64_t GetPeakRssKiB()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return counters.PeakWorkingSetSize / 1024;
+        return 0;
+#else
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+    #if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+    #else
+        return static_cast<uint64_t>(usage.ru_maxrss);
+    #endif
+#endif
+    }
+
+    static bool ParseOptions(const std::vector<std::string>& args, BenchmarkConfig& config)
+    {
+        ApplyPreset(config, config.scene);
+
+        // The preset goes first so explicit options override it wherever they appear
+        for (size_t i = 0; i + 1 < args.size(); i++)
+        {
+            if (args[i] == "--scene" && !ApplyPreset(config, args[i + 1]))
+            {
+                Logger::Log(LogLevel::ERROR, "Benchmark: unknown scene '" + args[i + 1] + "'");
+                return false;
+            }
+        }
+
+        try
+        {
+            for (size_t i = 0; i < args.size(); i++)
+            {
+                const std::string& arg = args[i];
+                bool hasValue = i + 1 < args.size();
+
+                if (arg == "--benchmark" || arg == "--textured" || arg == "--models" || arg == "--verbose")
+                {
+                    config.textured |= arg == "--textured";
+                    config.models |= arg == "--models";
+                    config.verbose |= arg == "--verbose";
+                }
+                else if (!hasValue)
+                {
+                    Logger::Log(LogLevel::ERROR, "Benchmark: missing value for " + arg);
+                    return false;
+                }
+                else
+                {
+                    const std::string& value = args[++i];
+                    if (arg == "--scene")             {}
+                    else if (arg == "--cubes")        config.cubes = std::max(0, std::stoi(value));
+                    else if (arg == "--point-lights") config.pointLights = std::max(0, std::stoi(value));
+                    else if (arg == "--spot-lights")  config.spotLights = std::max(0, std::stoi(value));
+                    else if (arg == "--frames")       config.frames = std::max(1, std::stoi(value));
+                    else if (arg == "--warmup")       config.warmupFrames = std::max(0, std::stoi(value));
+                    else if (arg == "--width")        config.width = std::max(1, std::stoi(value));
+                    else if (arg == "--height")       config.height = std::max(1, std::stoi(value));
+                    else if (arg == "--dt")
+                    {
+                        // Time treats a non-positive step as "use the wall clock", which would break the fixed timestep
+                        config.fixedDeltaTime = std::stof(value);
+                        if (!(config.fixedDeltaTime > 0.0f) || !std::isfinite(config.fixedDeltaTime))
+                        {
+                            Logger::Log(LogLevel::ERROR, "Benchmark: --dt must be a positive number of seconds");
+                            return false;
+                        }
+                    }
+                    else if (arg == "--output")       config.output = value;
+                    else
+                    {
+                        Logger::Log(LogLevel::ERROR, "Benchmark: unknown option " + arg);
+                        return false;
+                    }
+                }
+            }
+        }
+        catch (const std::exception&)
+        {
+            Logger::Log(LogLevel::ERROR, "Benchmark: invalid numeric option");
+            return false;
+        }
+
+        return true;
+    }
+
+    static double MsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+public:
+    static bool IsRequested(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; i++)
+            if (std::string(argv[i]) == "--benchmark")
+                return true;
+        return false;
+    }
+
+    // --benchmark [--scene small|medium|large|textured|models] [--cubes N] [--point-lights N]
+    // [--spot-lights N] [--textured] [--models] [--frames N] [--warmup N] [--width N] [--height N]
+    // [--dt seconds] [--output file] [--verbose]
+    static bool ParseArguments(int argc, char** argv, BenchmarkConfig& config)
+    {
+        // The engine adds its own sinks only once it initializes
+        ConsoleLogger console;
+        Logger::AddSink(&console);
+        bool parsed = ParseOptions(std::vector<std::string>(argv + 1, argv + argc), config);
+        Logger::RemoveSink(&console);
+        return parsed;
+    }
+
+    static int Run(const BenchmarkConfig& config)
+    {
+        auto processStart = std::chrono::steady_clock::now();
+
+        const LogLevel previousLevel = Logger::GetMinLevel();
+        if (!config.verbose)
+            Logger::SetMinLevel(LogLevel::WARNING);
+
+        Engine engine(config.width, config.height, "XEngine Benchmark", true);
+        if (!engine.Initialize())
+        {
+            Logger::Log(LogLevel::ERROR, "Benchmark: failed to initialize headless engine");
+            Logger::SetMinLevel(previousLevel);
+            return 1;
+        }
+        engine.GetTime()->SetFixedDeltaTime(config.fixedDeltaTime);
+
+        auto buildStart = std::chrono::steady_clock::now();
+        std::vector<std::string> models = config.models ? Model::FindSourceFiles("assets/objects") : std::vector<std::string>{};
+        BuildScene(engine, config, models);
+        double sceneBuildMs = MsSince(buildStart);
+
+        // Stream everything in before measuring; these frames are not part of the results
+        int loadFrames = 0;
+        while ((!engine.AreResourcesResident() || engine.HasPendingModels()) && loadFrames < MAX_LOAD_FRAMES)
+        {
+            engine.RunFrame();
+            loadFrames++;
+        }
+        double residentMs = MsSince(buildStart);
+        double startupMs = MsSince(processStart);
+
+        if (loadFrames == MAX_LOAD_FRAMES)
+            Logger::Log(LogLevel::WARNING, "Benchmark: resources still loading after " + std::to_string(loadFrames) + " frames");
+
+        for (int i = 0; i < config.warmupFrames; i++)
+            engine.RunFrame();
+
+        std::vector<double> frameMs;
+        std::vector<double> gpuWaitMs;
+        std::vector<ScopeSeries> scopes;
+        ProfileCounters counterTotals{};
+        frameMs.reserve(config.frames);
+        gpuWaitMs.reserve(config.frames);
+
+        for (int i = 0; i < config.frames; i++)
+        {
+            engine.RunFrame();
+
+            const FrameSample& sample = Profiler::GetLastFrame();
+            double swapMs = GetSwapMs();
+            frameMs.push_back(std::max(0.0, sample.cpuMs - swapMs));
+            gpuWaitMs.push_back(swapMs);
+            for (size_t c = 0; c < PROFILE_COUNTER_COUNT; c++)
+                counterTotals[c] += sample.counters[c];
+
+            RecordScopes(scopes, static_cast<size_t>(i));
+        }
+
+        json result;
+        result["benchmark"] = "scene";
+        result["scene"] = {
+            { "name", config.scene },
+            { "cubes", config.cubes },
+            { "pointLights", config.pointLights },
+            { "spotLights", config.spotLights },
+            { "textured", config.textured },
+            { "models", models },
+            { "width", config.width },
+            { "height", config.height },
+            { "warmupFrames", config.warmupFrames },
+            { "frames", config.frames },
+            { "fixedDeltaTime", config.fixedDeltaTime },
+        };
+        result["environment"] = {
+            { "glRenderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)) },
+            { "glVersion", reinterpret_cast<const char*>(glGetString(GL_VERSION)) },
+        };
+        result["startup"] = {
+            { "initializeMs", Round(engine.GetStartupMs()) },
+            { "sceneBuildMs", Round(sceneBuildMs) },
+            { "resourcesResidentMs", Round(residentMs) },
+            { "totalMs", Round(startupMs) },
+            { "loadFrames", loadFrames },
+        };
+        result["frameTime"] = ToJson(Summarize(frameMs));      // CPU only
+        result["gpuWait"] = ToJson(Summarize(gpuWaitMs));
+
+        json breakdown = json::object();
+        for (auto& scope : scopes)
+        {
+            scope.ms.resize(frameMs.size(), 0.0);
+            breakdown[scope.path] = ToJson(Summarize(scope.ms));
+        }
+        result["breakdown"] = breakdown;
+
+        json counters = json::object();
+        for (size_t c = 0; c < PROFILE_COUNTER_COUNT; c++)
+        {
+            double perFrame = frameMs.empty() ? 0.0 : static_cast<double>(counterTotals[c]) / frameMs.size();
+            counters[GetCounterName(static_cast<ProfileCounter>(c))] = std::round(perFrame * 10.0) / 10.0;
+        }
+        result["countersPerFrame"] = counters;
+        result["memory"] = { { "peakRssKiB", GetPeakRssKiB() } };
+
+        std::filesystem::path path(config.output);
+        std::error_code error;
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path(), error);
+
+        std::ofstream out(path);
+        if (!out)
+        {
+            Logger::Log(LogLevel::ERROR, "Benchmark: failed to write " + config.output);
+            engine.Shutdown();
+            Logger::SetMinLevel(previousLevel);
+            return 1;
+        }
+        out << result.dump(2) << '\n';
+        out.close();
+
+        engine.Shutdown();
+        Logger::SetMinLevel(previousLevel);
+        Logger::Log(LogLevel::INFO, "Benchmark '" + config.scene + "': " + std::to_string(config.frames) + " frames, CPU p50 " +
+            std::to_string(result["frameTime"]["p50Ms"].get<double>()) + " ms, p99 " +
+            std::to_string(result["frameTime"]["p99Ms"].get<double>()) + " ms, GPU wait p50 " +
+            std::to_string(result["gpuWait"]["p50Ms"].get<double>()) + " ms, peak RSS " +
+            std::to_string(GetPeakRssKiB() / 1024) + " MiB -> " + config.output);
+        return 0;
+    }
+};
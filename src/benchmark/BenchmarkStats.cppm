@@ -0,0 +1,60 @@
+module;
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+export module XEngine.Benchmark.Stats;
+
+// Shared by the headless scene benchmark and the onBenchmark* commands, so every
+// report uses the same percentile definition
+
+export struct SampleSummary
+{
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Nearest-rank percentile of sorted samples
+export double Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+export SampleSummary Summarize(std::vector<double> samples)
+{
+    SampleSummary summary;
+    if (samples.empty())
+        return summary;
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double sample : samples)
+        sum += sample;
+
+    summary.count = samples.size();
+    summary.mean = sum / samples.size();
+    summary.p50 = Percentile(samples, 50.0);
+    summary.p95 = Percentile(samples, 95.0);
+    summary.p99 = Percentile(samples, 99.0);
+    summary.max = samples.back();
+    return summary;
+}
+
+export template<typename Func>
+double MeasureMs(Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,472 @@
+module;
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <entt.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+export module XEngine.Benchmark.Micro;
+
+import XEngine.Benchmark.Stats;
+
+import XEngine.Core.Logger;
+import XEngine.Core.Logging.FileLogger;
+import XEngine.Core.ThreadPool;
+
+import XEngine.Rendering.MeshData;
+import XEngine.Rendering.UniformBlocks;
+
+import XEngine.Resource.Shader.ShaderManager;
+import XEngine.Resource.Shader.ShaderCompiler;
+import XEngine.Resource.Texture.TextureManager;
+
+import XEngine.Scene.Model;
+
+import XEngine.ECS.ECSWorld;
+import XEngine.ECS.Components;
+import XEngine.ECS.Systems;
+
+// Focused before/after measurements behind the onBenchmark* commands. Each one
+// logs its results; the headless scene benchmark lives in XEngine.Benchmark.
+export class MicroBenchmarks
+{
+public:
+    // Per-frame camera and light upload: string-built glUniform* calls against
+    // the camera and light uniform blocks
+    static void Uniforms(ShaderManager& shaderManager, int iterations)
+    {
+        ShaderObj* basic = shaderManager.GetShader("basic");
+        if (!basic || !basic->IsValid())
+        {
+            Logger::Log(LogLevel::ERROR, "onBenchmarkUniforms requires the 'basic' shader");
+            return;
+        }
+
+        // The engine shaders read these through uniform blocks now, so the "before"
+        // side gets a throwaway program that still declares them as plain uniforms
+        const std::string legacyVertex = R"(#version 330 core
+            layout (location = 0) in vec3 aPos;
+            uniform mat4 projection;
+            uniform mat4 view;
+            out vec3 FragPos;
+            void main()
+            {
+                FragPos = aPos;
+                gl_Position = projection * view * vec4(aPos, 1.0);
+            })";
+
+        const std::string legacyFragment = R"(#version 330 core
+            #define MAX_LIGHTS )" + std::to_string(MAX_LIGHTS) + R"(
+            struct Light
+            {
+                int type;
+                vec3 position, direction, ambient, diffuse, specular;
+                float constant, linear, quadratic, innerCutoff, outerCutoff;
+            };
+            uniform Light lights[MAX_LIGHTS];
+            uniform int numLights;
+            uniform vec3 viewPos;
+            in vec3 FragPos;
+            out vec4 FragColor;
+            void main()
+            {
+                vec3 color = vec3(0.0);
+                for (int i = 0; i < numLights; i++)
+                {
+                    Light l = lights[i];
+                    float k = l.constant + l.linear + l.quadratic + l.innerCutoff + l.outerCutoff + float(l.type);
+                    color += (l.ambient + l.diffuse + l.specular) * k + dot(l.position - FragPos, l.direction - viewPos);
+                }
+                FragColor = vec4(color, 1.0);
+            })";
+
+        GLuint program = CompileShader(legacyVertex, legacyFragment, "");
+        std::string lastLight = "lights[" + std::to_string(MAX_LIGHTS - 1) + "].outerCutoff";
+        if (glGetUniformLocation(program, "projection") < 0 || glGetUniformLocation(program, lastLight.c_str()) < 0)
+        {
+            Logger::Log(LogLevel::ERROR, "onBenchmarkUniforms: legacy shader is missing its uniforms");
+            glDeleteProgram(program);
+            return;
+        }
+
+        glm::mat4 projection(1.0f);
+        glm::mat4 view(1.0f);
+        glm::vec3 viewPos(0.0f);
+        glm::vec3 value(1.0f);
+
+        LightsBlock lights{};
+        lights.numLights = MAX_LIGHTS;
+
+        // The per-frame upload as it was done before uniform blocks: a string
+        // build and glGetUniformLocation for every value of every light
+        auto legacyFrame = [&]()
+        {
+            auto loc = [program](const std::string& n) { return glGetUniformLocation(program, n.c_str()); };
+
+            glUniformMatrix4fv(loc("projection"), 1, GL_FALSE, &projection[0][0]);
+            glUniformMatrix4fv(loc("view"), 1, GL_FALSE, &view[0][0]);
+            glUniform3fv(loc("viewPos"), 1, &viewPos[0]);
+
+            for (int i = 0; i < MAX_LIGHTS; i++)
+            {
+                std::string base = "lights[" + std::to_string(i) + "]";
+                glUniform1i(loc(base + ".type"), 1);
+                glUniform3fv(loc(base + ".position"), 1, &value[0]);
+                glUniform3fv(loc(base + ".direction"), 1, &value[0]);
+                glUniform3fv(loc(base + ".ambient"), 1, &value[0]);
+                glUniform3fv(loc(base + ".diffuse"), 1, &value[0]);
+                glUniform3fv(loc(base + ".specular"), 1, &value[0]);
+                glUniform1f(loc(base + ".constant"), 1.0f);
+                glUniform1f(loc(base + ".linear"), 1.0f);
+                glUniform1f(loc(base + ".quadratic"), 1.0f);
+                glUniform1f(loc(base + ".innerCutoff"), 1.0f);
+                glUniform1f(loc(base + ".outerCutoff"), 1.0f);
+            }
+
+            glUniform1i(loc("numLights"), MAX_LIGHTS);
+        };
+
+        auto blockFrame = [&]()
+        {
+            shaderManager.UpdateCameraBlock(projection, view, viewPos);
+            shaderManager.UpdateLightsBlock(lights);
+        };
+
+        // Microseconds per frame, including the driver work flushed by glFinish
+        auto measure = [iterations](auto&& frame)
+        {
+            glFinish();
+            double ms = MeasureMs([&]()
+            {
+                for (int i = 0; i < iterations; i++)
+                    frame();
+                glFinish();
+            });
+            return ms * 1000.0 / iterations;
+        };
+
+        glUseProgram(program);
+        double legacyUs = measure(legacyFrame);
+        glUseProgram(0);
+        glDeleteProgram(program);
+
+        shaderManager.Bind("basic");
+        double blockUs = measure(blockFrame);
+        shaderManager.Unbind();
+
+        Logger::Log(LogLevel::INFO, "Uniform upload per frame (" + std::to_string(iterations) + " frames, " +
+            std::to_string(MAX_LIGHTS) + " lights): legacy " + std::to_string(legacyUs) +
+            " us, uniform blocks " + std::to_string(blockUs) + " us");
+    }
+
+    // Rotation + hierarchy update on synthetic scenes, for each worker count, and
+    // once more with loader-sized jobs queued on the same pool
+    static void Transforms(int frames)
+    {
+        std::vector<size_t> workerCounts = { 0 };
+        for (size_t w = 1; w <= ThreadPool::DefaultThreadCount(); w *= 2)
+            workerCounts.push_back(w);
+
+        for (size_t entityCount : { 1000, 10000, 100000 })
+        {
+            // Synthetic scene: every entity spins, every 8th one is parented to its group root
+            ECSWorld world;
+            auto& registry = world.GetRegistry();
+            entt::entity root = entt::null;
+
+            for (size_t i = 0; i < entityCount; i++)
+            {
+                entt::entity entity = registry.create();
+                registry.emplace<TransformComponent>(entity, glm::vec3(float(i % 100), 0.0f, float(i / 100)));
+                auto& rotation = registry.emplace<RotationComponent>(entity, 50.0f);
+                rotation.axis = glm::vec3(0.0f, 1.0f, 0.0f);
+
+                if (i % 8 == 0)
+                    root = entity;
+                else if (i % 8 == 7)
+                    world.SetParent(entity, root);
+            }
+
+            auto run = [&](ThreadPool& pool)
+            {
+                RotationSystem rotation;
+                TransformSystem transform;
+                transform.Update(world, pool);
+
+                std::vector<double> frameMs;
+                frameMs.reserve(frames);
+                for (int f = 0; f < frames; f++)
+                {
+                    frameMs.push_back(MeasureMs([&]()
+                    {
+                        rotation.Update(world, pool, 1.0f / 60.0f);
+                        transform.Update(world, pool);
+                    }));
+                }
+                return Summarize(std::move(frameMs));
+            };
+
+            double singleThreadMs = 0.0;
+            for (size_t workers : workerCounts)
+            {
+                ThreadPool pool(workers);
+                SampleSummary summary = run(pool);
+                if (workers == 0)
+                    singleThreadMs = summary.mean;
+
+                Logger::Log(LogLevel::INFO, "Transform update: " + std::to_string(entityCount) + " entities, " +
+                    std::to_string(workers + 1) + " threads: " + std::to_string(summary.mean) + " ms/frame (x" +
+                    std::to_string(singleThreadMs / summary.mean) + ")");
+            }
+
+            // Frame work must not wait behind queued loads
+            size_t workers = workerCounts.back();
+            if (workers == 0)
+                continue;
+
+            ThreadPool pool(workers);
+            const size_t loadJobs = workers * 8;
+            for (size_t j = 0; j < loadJobs; j++)
+                pool.Submit([]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+
+            SampleSummary summary = run(pool);
+            Logger::Log(LogLevel::INFO, "Transform update: " + std::to_string(entityCount) + " entities, " +
+                std::to_string(workers + 1) + " threads, " + std::to_string(loadJobs) + " queued 20 ms jobs: " +
+                std::to_string(summary.mean) + " ms/frame, worst " + std::to_string(summary.max) + " ms");
+        }
+    }
+
+    // Every file under assets/textures: serial vs pooled decode, then through the texture cache
+    static void TextureLoading(ThreadPool* pool)
+    {
+        std::vector<std::string> paths;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator("assets/textures", error))
+            if (entry.is_regular_file())
+                paths.push_back(entry.path().generic_string());
+
+        // Read everything once so both runs hit the OS file cache equally
+        size_t bytes = 0;
+        for (const auto& path : paths)
+        {
+            std::ifstream file(path, std::ios::binary);
+            bytes += std::vector<char>(std::istreambuf_iterator<char>(file), {}).size();
+        }
+
+        // Returns { ms until every handle was handed out, ms until every texture was resident }
+        TextureLoadStats last;
+        auto run = [&](ThreadPool* runPool, bool useCache)
+        {
+            TextureManager manager(runPool);
+            manager.SetCacheEnabled(useCache);
+
+            double requestedMs = 0.0;
+            double residentMs = MeasureMs([&]()
+            {
+                requestedMs = MeasureMs([&]()
+                {
+                    for (const auto& path : paths)
+                        manager.LoadTexture(path);
+                });
+
+                while (manager.GetPendingCount() > 0)
+                    if (manager.ProcessUploads(0.0) == 0)
+                        std::this_thread::yield();
+
+                glFinish();
+            });
+
+            last = manager.GetStats();
+            return std::make_pair(requestedMs, residentMs);
+        };
+
+        auto serial = run(nullptr, false);
+        auto async = run(pool, false);
+        size_t uncompressedVRAM = last.vramBytes;
+
+        // First cached run cooks whatever is missing, the second one is the steady state
+        auto cook = run(pool, true);
+        size_t cooked = last.cacheMisses;
+        auto cached = run(pool, true);
+
+        Logger::Log(LogLevel::INFO, "Texture loading, " + std::to_string(paths.size()) + " files (" +
+            std::to_string(bytes / 1024) + " KiB): serial " + std::to_string(serial.second) + " ms; async " +
+            std::to_string(async.second) + " ms resident with " + std::to_string(pool ? pool->GetThreadCount() : 0) +
+            " workers, handles returned after " + std::to_string(async.first) + " ms (x" +
+            std::to_string(serial.second / async.second) + ")");
+
+        Logger::Log(LogLevel::INFO, "Texture cache: " + std::to_string(cached.second) + " ms resident (x" +
+            std::to_string(async.second / cached.second) + " vs decoding), cooked " + std::to_string(cooked) +
+            " in " + std::to_string(cook.second) + " ms; VRAM " + std::to_string(uncompressedVRAM / 1024) + " -> " +
+            std::to_string(last.vramBytes / 1024) + " KiB");
+    }
+
+    // Assimp import vs the cooked mesh file, per model under assets/objects
+    static void Meshes()
+    {
+        std::vector<std::string> paths = Model::FindSourceFiles("assets/objects");
+        if (paths.empty())
+        {
+            Logger::Log(LogLevel::WARNING, "Mesh benchmark: no model files under assets/objects");
+            return;
+        }
+
+        for (const auto& path : paths)
+        {
+            // Make sure a fresh cooked file exists before timing the cached path
+            Model::Import(path);
+
+            ModelData source, cooked;
+            double importMs = MeasureMs([&]() { source = Model::Import(path, false); });
+            double cookedMs = MeasureMs([&]() { cooked = Model::LoadCooked(path); });
+
+            if (!source.valid || !cooked.valid)
+            {
+                Logger::Log(LogLevel::WARNING, "Mesh benchmark: could not load " + path);
+                continue;
+            }
+
+            size_t sourceVertices = 0, sourceBytes = 0;
+            for (const auto& mesh : source.meshes)
+            {
+                sourceVertices += mesh.vertices.size();
+                sourceBytes += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int);
+            }
+
+            size_t cookedVertices = 0, cookedBytes = 0;
+            for (const auto& mesh : cooked.meshes)
+            {
+                cookedVertices += mesh.cookedVertexCount;
+                cookedBytes += mesh.cookedVertexCount * mesh.cookedLayout.stride +
+                    mesh.cookedIndexCount * (mesh.cookedIndexType == GL_UNSIGNED_SHORT ? 2 : 4);
+            }
+
+            std::error_code ec;
+            auto fileSize = std::filesystem::file_size(path, ec);
+            auto cookedFileSize = std::filesystem::file_size(Model::GetCookedPath(path), ec);
+
+            Logger::Log(LogLevel::INFO, "Mesh " + path + ": import " + std::to_string(importMs) + " ms, cooked " +
+                std::to_string(cookedMs) + " ms (x" + std::to_string(importMs / cookedMs) +
+                "); file " + std::to_string(fileSize / 1024) + " -> " + std::to_string(cookedFileSize / 1024) +
+                " KiB; GPU " + std::to_string(sourceBytes / 1024) + " -> " + std::to_string(cookedBytes / 1024) +
+                " KiB; vertices " + std::to_string(sourceVertices) + " -> " + std::to_string(cookedVertices));
+        }
+    }
+
+    // Log call latency from many threads: synchronous sinks vs the async backend
+    static void Logging()
+    {
+        const unsigned threadCount = std::max(4u, std::thread::hardware_concurrency());
+        const size_t callsPerThread = 20000;
+
+        // Write to a scratch file so the run neither floods the console nor the session log.
+        // Sinks are process-wide, so while the benchmark runs every thread's records,
+        // including pool jobs and the main thread, land in the scratch file and are
+        // deleted with it.
+        const auto folder = std::filesystem::temp_directory_path() / "xengine-log-benchmark";
+        const bool wasAsync = Logger::IsAsync();
+        const AsyncLogConfig savedConfig = Logger::GetAsyncConfig();
+        const std::vector<ILogSink*> savedSinks = Logger::GetSinks();
+
+        Logger::Log(LogLevel::WARNING, "Logging benchmark: log output from all threads is discarded until it finishes");
+        Logger::Flush();
+
+        struct Result
+        {
+            std::string name;
+            double callsPerSecond;
+            SampleSummary latencyNs;
+            uint64_t dropped;
+        };
+        std::vector<Result> results;
+
+        auto run = [&](const std::string& name, bool async, LogOverflowPolicy overflow)
+        {
+            Logger::StopAsync();
+            Logger::ClearSinks();
+
+            FileLogger sink(folder.string());
+            Logger::AddSink(&sink);
+
+            if (async)
+            {
+                AsyncLogConfig config;
+                config.overflow = overflow;
+                Logger::StartAsync(config);
+            }
+
+            const uint64_t droppedBefore = Logger::GetStats().dropped;
+            std::vector<std::vector<double>> latencies(threadCount);
+            std::atomic<bool> go{ false };
+            std::vector<std::thread> threads;
+
+            for (unsigned t = 0; t < threadCount; t++)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    auto& samples = latencies[t];
+                    samples.reserve(callsPerThread);
+                    while (!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+
+                    for (size_t i = 0; i < callsPerThread; i++)
+                    {
+                        samples.push_back(MeasureMs([&]()
+                        {
+                            Logger::Log(LogLevel::INFO, LogCategory::CORE, "Benchmark record " + std::to_string(i) +
+                                " from worker " + std::to_string(t) + ": frame stats nominal");
+                        }) * 1e6);
+                    }
+                });
+            }
+
+            double wallMs = MeasureMs([&]()
+            {
+                go.store(true, std::memory_order_release);
+                for (auto& thread : threads)
+                    thread.join();
+            });
+
+            Logger::Flush();
+            Logger::StopAsync();
+            Logger::ClearSinks();
+
+            std::vector<double> all;
+            for (auto& samples : latencies)
+                all.insert(all.end(), samples.begin(), samples.end());
+
+            results.push_back({ name, all.size() / (wallMs / 1000.0), Summarize(std::move(all)),
+                Logger::GetStats().dropped - droppedBefore });
+        };
+
+        run("sync", false, LogOverflowPolicy::DROP);
+        run("async/drop", true, LogOverflowPolicy::DROP);
+        run("async/block", true, LogOverflowPolicy::BLOCK);
+
+        for (auto* sink : savedSinks)
+            Logger::AddSink(sink);
+        if (wasAsync)
+            Logger::StartAsync(savedConfig);
+
+        std::error_code ec;
+        std::filesystem::remove_all(folder, ec);
+
+        for (const auto& result : results)
+            Logger::Log(LogLevel::INFO, "Logging " + result.name + ", " + std::to_string(threadCount) + " threads: " +
+                std::to_string(static_cast<uint64_t>(result.callsPerSecond)) + " calls/s, p50 " +
+                std::to_string(result.latencyNs.p50) + " ns, p99 " + std::to_string(result.latencyNs.p99) +
+                " ns, dropped " + std::to_string(result.dropped));
+    }
+};
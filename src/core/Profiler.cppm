@@ -0,0 +1,562 @@
+module;
+
+#include <glad/glad.h>
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+export module XEngine.Core.Profiler;
+
+import XEngine.Core.Logger;
+
+using json = nlohmann::json;
+
+export enum class ProfileCounter
+{
+    DRAW_CALLS,
+    TRIANGLES,
+    SHADER_BINDS,
+    TEXTURE_BINDS,
+    BUFFER_UPLOADS,
+    UPLOAD_BYTES,
+    COUNT
+};
+
+export constexpr size_t PROFILE_COUNTER_COUNT = static_cast<size_t>(ProfileCounter::COUNT);
+
+export constexpr const char* GetCounterName(ProfileCounter counter)
+{
+    switch (counter)
+    {
+        case ProfileCounter::DRAW_CALLS:     return "Draw calls";
+        case ProfileCounter::TRIANGLES:      return "Triangles";
+        case ProfileCounter::SHADER_BINDS:   return "Shader binds";
+        case ProfileCounter::TEXTURE_BINDS:  return "Texture binds";
+        case ProfileCounter::BUFFER_UPLOADS: return "Buffer uploads";
+        case ProfileCounter::UPLOAD_BYTES:   return "Upload bytes";
+        default:                             return "?";
+    }
+}
+
+export using ProfileCounters = std::array<uint64_t, PROFILE_COUNTER_COUNT>;
+
+// Scope names must have static storage (string literals); they are stored by pointer
+export struct ProfileEvent
+{
+    const char* name;
+    uint32_t depth;
+    double startMs;         // relative to the start of the frame
+    double durationMs;
+};
+
+export struct GpuProfileEvent
+{
+    const char* name;
+    double submitMs;        // CPU time the scope was issued, relative to the frame
+    double durationMs;
+};
+
+export struct FrameSample
+{
+    uint64_t frame = 0;
+    double cpuMs = 0.0;
+    double gpuMs = -1.0;    // negative until the timer queries resolve
+    ProfileCounters counters{};
+};
+
+export struct ScopeSummary
+{
+    const char* name;
+    uint32_t depth;
+    double lastMs;
+    double averageMs;       // exponential moving average
+};
+
+// Frame profiler for the main (GL) thread. CPU scopes nest and cost two clock
+// reads each; GPU scopes use GL_TIME_ELAPSED queries, which cannot nest, and are
+// read back two frames later only once available, so the pipeline never stalls.
+export class Profiler
+{
+public:
+    static constexpr size_t HISTORY_SIZE = 240;
+    static constexpr size_t MAX_SCOPE_DEPTH = 32;
+    static constexpr size_t MAX_GPU_SCOPES = 16;
+    static constexpr size_t GPU_QUERY_FRAMES = 2;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct GpuFrame
+    {
+        std::array<GLuint, MAX_GPU_SCOPES> queries{};
+        std::array<const char*, MAX_GPU_SCOPES> names{};
+        std::array<double, MAX_GPU_SCOPES> submitMs{};
+        size_t count = 0;
+        uint64_t frame = 0;
+        bool pending = false;
+    };
+
+    struct CaptureEvent
+    {
+        const char* name;
+        uint32_t tid;
+        double startMs;     // relative to the start of the capture
+        double durationMs;
+    };
+
+    struct CaptureFrame
+    {
+        uint64_t frame;
+        double startMs;
+        double durationMs;
+        ProfileCounters counters;
+    };
+
+    struct State
+    {
+        bool enabled = true;
+        bool inFrame = false;
+        std::thread::id mainThread;
+
+        uint64_t frameIndex = 0;
+        Clock::time_point frameStart;
+        ProfileCounters counters{};
+
+        std::vector<ProfileEvent> events;
+        std::vector<ProfileEvent> lastEvents;
+        std::array<size_t, MAX_SCOPE_DEPTH> stack{};
+        uint32_t depth = 0;
+
+        std::vector<ScopeSummary> summaries;
+        std::array<FrameSample, HISTORY_SIZE> history{};
+        std::array<float, HISTORY_SIZE> cpuTimes{};
+        std::array<float, HISTORY_SIZE> gpuTimes{};
+
+        std::array<GpuFrame, GPU_QUERY_FRAMES> gpuFrames{};
+        GpuFrame* gpuCurrent = nullptr;
+        bool gpuInitialized = false;
+        bool gpuActive = false;
+        uint64_t gpuSkipped = 0;
+        std::vector<GpuProfileEvent> lastGpuEvents;
+
+        // Capture
+        int captureRequested = 0;
+        std::string capturePath;
+        bool capturing = false;
+        uint64_t captureFirst = 0;
+        uint64_t captureLast = 0;
+        Clock::time_point captureOrigin;
+        std::vector<CaptureEvent> captureEvents;
+        std::vector<CaptureFrame> captureFrames;
+    };
+
+    static State& state()
+    {
+        static State s;
+        return s;
+    }
+
+    static double ToMs(Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    static bool IsMainThread(const State& s)
+    {
+        return s.inFrame && std::this_thread::get_id() == s.mainThread;
+    }
+
+    // ───── GPU queries ─────
+
+    static void InitializeGpu(State& s)
+    {
+        s.gpuInitialized = true;
+        if (!glGenQueries)
+            return;
+
+        for (GpuFrame& frame : s.gpuFrames)
+            glGenQueries(static_cast<GLsizei>(MAX_GPU_SCOPES), frame.queries.data());
+    }
+
+    // Reads back the queries of the slot about to be reused; returns false if the
+    // GPU has not finished with them yet
+    static bool ResolveGpuFrame(State& s, GpuFrame& frame)
+    {
+        if (!frame.pending)
+            return true;
+
+        if (frame.count > 0)
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(frame.queries[frame.count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                return false;
+        }
+
+        double totalMs = 0.0;
+        s.lastGpuEvents.clear();
+        for (size_t i = 0; i < frame.count; i++)
+        {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &elapsed);
+            double ms = static_cast<double>(elapsed) / 1.0e6;
+            totalMs += ms;
+            s.lastGpuEvents.push_back({ frame.names[i], frame.submitMs[i], ms });
+
+            AddCapturedGpuEvent(s, frame.frame, frame.names[i], frame.submitMs[i], ms);
+        }
+
+        FrameSample& sample = s.history[frame.frame % HISTORY_SIZE];
+        if (sample.frame == frame.frame)
+        {
+            sample.gpuMs = totalMs;
+            s.gpuTimes[frame.frame % HISTORY_SIZE] = static_cast<float>(totalMs);
+        }
+
+        frame.pending = false;
+        frame.count = 0;
+        return true;
+    }
+
+    // ───── Capture ─────
+
+    static void AddCapturedGpuEvent(State& s, uint64_t frame, const char* name, double submitMs, double durationMs)
+    {
+        if (frame < s.captureFirst || frame > s.captureLast)
+            return;
+
+        for (const CaptureFrame& captured : s.captureFrames)
+        {
+            if (captured.frame == frame)
+            {
+                s.captureEvents.push_back({ name, 2, captured.startMs + submitMs, durationMs });
+                return;
+            }
+        }
+    }
+
+    static void WriteCapture(State& s)
+    {
+        json events = json::array();
+
+        auto thread = [&](uint32_t tid, const char* name)
+        {
+            events.push_back({ { "name", "thread_name" }, { "ph", "M" }, { "pid", 1 }, { "tid", tid },
+                { "args", { { "name", name } } } });
+        };
+        thread(1, "Main thread");
+        thread(2, "GPU");
+
+        for (const CaptureFrame& frame : s.captureFrames)
+        {
+            events.push_back({ { "name", "Frame " + std::to_string(frame.frame) }, { "cat", "frame" }, { "ph", "X" },
+                { "ts", frame.startMs * 1000.0 }, { "dur", frame.durationMs * 1000.0 }, { "pid", 1 }, { "tid", 1 } });
+
+            json args = json::object();
+            for (size_t i = 0; i < PROFILE_COUNTER_COUNT; i++)
+                args[GetCounterName(static_cast<ProfileCounter>(i))] = frame.counters[i];
+            events.push_back({ { "name", "Counters" }, { "ph", "C" }, { "ts", frame.startMs * 1000.0 },
+                { "pid", 1 }, { "args", args } });
+        }
+
+        for (const CaptureEvent& event : s.captureEvents)
+        {
+            events.push_back({ { "name", event.name }, { "cat", event.tid == 2 ? "gpu" : "cpu" }, { "ph", "X" },
+                { "ts", event.startMs * 1000.0 }, { "dur", event.durationMs * 1000.0 }, { "pid", 1 }, { "tid", event.tid } });
+        }
+
+        json trace = { { "traceEvents", events }, { "displayTimeUnit", "ms" } };
+
+        std::error_code error;
+        std::filesystem::path path(s.capturePath);
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path(), error);
+
+        std::ofstream out(path);
+        if (!out)
+        {
+            Logger::Log(LogLevel::ERROR, LogCategory::CORE, "Profiler: failed to write trace " + s.capturePath);
+            return;
+        }
+        out << trace.dump();
+
+        Logger::Log(LogLevel::INFO, LogCategory::CORE, "Profiler: captured " + std::to_string(s.captureFrames.size()) +
+            " frames to " + s.capturePath);
+    }
+
+    static void FinishCapture(State& s)
+    {
+        WriteCapture(s);
+        s.captureEvents.clear();
+        s.captureFrames.clear();
+    }
+
+    static void RecordCaptureFrame(State& s, double cpuMs)
+    {
+        double startMs = ToMs(s.frameStart - s.captureOrigin);
+        s.captureFrames.push_back({ s.frameIndex, startMs, cpuMs, s.counters });
+
+        for (const ProfileEvent& event : s.events)
+            s.captureEvents.push_back({ event.name, 1, startMs + event.startMs, event.durationMs });
+    }
+
+    static void UpdateSummaries(State& s)
+    {
+        for (const ProfileEvent& event : s.events)
+        {
+            ScopeSummary* summary = nullptr;
+            for (ScopeSummary& existing : s.summaries)
+            {
+                if (existing.depth == event.depth && (existing.name == event.name || std::strcmp(existing.name, event.name) == 0))
+                {
+                    summary = &existing;
+                    break;
+                }
+            }
+
+            if (summary)
+            {
+                summary->lastMs = event.durationMs;
+                summary->averageMs += (event.durationMs - summary->averageMs) * 0.05;
+            }
+            else
+            {
+                s.summaries.push_back({ event.name, event.depth, event.durationMs, event.durationMs });
+            }
+        }
+    }
+
+public:
+    static void SetEnabled(bool enabled) { state().enabled = enabled; }
+    static bool IsEnabled() { return state().enabled; }
+
+    // ───── Frame ─────
+
+    static void BeginFrame()
+    {
+        State& s = state();
+        if (!s.enabled)
+            return;
+
+        s.inFrame = true;
+        s.mainThread = std::this_thread::get_id();
+        s.frameStart = Clock::now();
+        s.counters.fill(0);
+        s.events.clear();
+        s.depth = 0;
+
+        if (!s.gpuInitialized)
+            InitializeGpu(s);
+
+        // Reuse the query slot from GPU_QUERY_FRAMES ago only if its results are in
+        GpuFrame& slot = s.gpuFrames[s.frameIndex % GPU_QUERY_FRAMES];
+        if (glGenQueries && ResolveGpuFrame(s, slot))
+        {
+            slot.frame = s.frameIndex;
+            s.gpuCurrent = &slot;
+        }
+        else
+        {
+            s.gpuCurrent = nullptr;
+            s.gpuSkipped++;
+        }
+
+        if (s.captureRequested > 0 && !s.capturing && s.captureFrames.empty())
+        {
+            s.capturing = true;
+            s.captureOrigin = s.frameStart;
+            s.captureFirst = s.frameIndex;
+            s.captureLast = s.frameIndex + s.captureRequested - 1;
+            s.captureRequested = 0;
+        }
+        else if (!s.capturing && !s.captureFrames.empty() && s.frameIndex > s.captureLast + GPU_QUERY_FRAMES)
+        {
+            // GPU results of the captured frames have had time to come back
+            FinishCapture(s);
+        }
+    }
+
+    static void EndFrame()
+    {
+        State& s = state();
+        if (!s.inFrame)
+            return;
+
+        while (s.depth > 0)
+            EndScope();
+        if (s.gpuActive)
+            EndGpuScope();
+
+        double cpuMs = ToMs(Clock::now() - s.frameStart);
+
+        if (s.gpuCurrent)
+            s.gpuCurrent->pending = true;
+
+        size_t slot = s.frameIndex % HISTORY_SIZE;
+        s.history[slot] = { s.frameIndex, cpuMs, -1.0, s.counters };
+        s.cpuTimes[slot] = static_cast<float>(cpuMs);
+        s.gpuTimes[slot] = 0.0f;
+
+        UpdateSummaries(s);
+
+        if (s.capturing)
+        {
+            RecordCaptureFrame(s, cpuMs);
+            if (s.frameIndex >= s.captureLast)
+                s.capturing = false;
+        }
+
+        std::swap(s.events, s.lastEvents);
+        s.inFrame = false;
+        s.frameIndex++;
+    }
+
+    // ───── Scopes ─────
+
+    // Returns false when the scope was not started (other thread, outside a frame, too deep)
+    static bool BeginScope(const char* name)
+    {
+        State& s = state();
+        if (!IsMainThread(s) || s.depth >= MAX_SCOPE_DEPTH)
+            return false;
+
+        s.stack[s.depth] = s.events.size();
+        s.events.push_back({ name, s.depth, ToMs(Clock::now() - s.frameStart), 0.0 });
+        s.depth++;
+        return true;
+    }
+
+    static void EndScope()
+    {
+        State& s = state();
+        if (!IsMainThread(s) || s.depth == 0)
+            return;
+
+        s.depth--;
+        ProfileEvent& event = s.events[s.stack[s.depth]];
+        event.durationMs = ToMs(Clock::now() - s.frameStart) - event.startMs;
+    }
+
+    // Returns false when the scope was not started (nested, full, or no free queries)
+    static bool BeginGpuScope(const char* name)
+    {
+        State& s = state();
+        if (!IsMainThread(s) || !s.gpuCurrent || s.gpuActive || s.gpuCurrent->count >= MAX_GPU_SCOPES)
+            return false;
+
+        GpuFrame& frame = *s.gpuCurrent;
+        frame.names[frame.count] = name;
+        frame.submitMs[frame.count] = ToMs(Clock::now() - s.frameStart);
+        glBeginQuery(GL_TIME_ELAPSED, frame.queries[frame.count]);
+        s.gpuActive = true;
+        return true;
+    }
+
+    static void EndGpuScope()
+    {
+        State& s = state();
+        if (!s.gpuActive)
+            return;
+
+        glEndQuery(GL_TIME_ELAPSED);
+        s.gpuCurrent->count++;
+        s.gpuActive = false;
+    }
+
+    // ───── Counters ─────
+
+    static void Count(ProfileCounter counter, uint64_t amount = 1)
+    {
+        state().counters[static_cast<size_t>(counter)] += amount;
+    }
+
+    // ───── Capture ─────
+
+    // Writes the next `frames` frames as Chrome trace-event JSON (chrome://tracing, Perfetto)
+    static void RequestCapture(int frames, const std::string& path = "")
+    {
+        State& s = state();
+        if (frames <= 0 || s.capturing || !s.captureFrames.empty())
+            return;
+
+        s.captureRequested = frames;
+        s.capturePath = path.empty() ? "../log/frame-trace-" + std::to_string(s.frameIndex) + ".json" : path;
+        Logger::Log(LogLevel::INFO, LogCategory::CORE, "Profiler: capturing " + std::to_string(frames) + " frames");
+    }
+
+    static bool IsCapturing()
+    {
+        const State& s = state();
+        return s.captureRequested > 0 || s.capturing || !s.captureFrames.empty();
+    }
+
+    // ───── History ─────
+
+    static uint64_t GetFrameIndex() { return state().frameIndex; }
+    static uint64_t GetSkippedGpuFrames() { return state().gpuSkipped; }
+
+    static const FrameSample& GetLastFrame()
+    {
+        const State& s = state();
+        return s.history[(s.frameIndex + HISTORY_SIZE - 1) % HISTORY_SIZE];
+    }
+
+    // Ring buffers indexed by frame % HISTORY_SIZE; GetHistoryOffset() is the oldest entry
+    static const std::array<FrameSample, HISTORY_SIZE>& GetHistory() { return state().history; }
+    static const float* GetCpuTimes() { return state().cpuTimes.data(); }
+    static const float* GetGpuTimes() { return state().gpuTimes.data(); }
+    static int GetHistoryOffset() { return static_cast<int>(state().frameIndex % HISTORY_SIZE); }
+
+    static const std::vector<ProfileEvent>& GetLastEvents() { return state().lastEvents; }
+    static const std::vector<GpuProfileEvent>& GetLastGpuEvents() { return state().lastGpuEvents; }
+    static const std::vector<ScopeSummary>& GetScopeSummaries() { return state().summaries; }
+
+    static void Shutdown()
+    {
+        State& s = state();
+        if (!s.captureFrames.empty())
+            FinishCapture(s);
+
+        if (s.gpuInitialized && glDeleteQueries)
+        {
+            for (GpuFrame& frame : s.gpuFrames)
+                glDeleteQueries(static_cast<GLsizei>(MAX_GPU_SCOPES), frame.queries.data());
+        }
+        s.gpuInitialized = false;
+        s.gpuCurrent = nullptr;
+    }
+};
+
+export class ProfileScope
+{
+private:
+    bool started;
+
+public:
+    explicit ProfileScope(const char* name) : started(Profiler::BeginScope(name)) {}
+    ~ProfileScope() { if (started) Profiler::EndScope(); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+export class GpuProfileScope
+{
+private:
+    bool started;
+
+public:
+    explicit GpuProfileScope(const char* name) : started(Profiler::BeginGpuScope(name)) {}
+    ~GpuProfileScope() { if (started) Profiler::EndGpuScope(); }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+};
@@ -0,0 +1,161 @@
+module;
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+export module XEngine.Core.ThreadPool;
+
+import XEngine.Core.Logger;
+
+export class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+    std::atomic<bool> cancelled{false};
+
+    void WorkerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+                if (stopping && jobs.empty())
+                    return;
+
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+public:
+    // Worker count excludes the calling thread, which always takes part in ParallelFor
+    explicit ThreadPool(size_t threadCount = DefaultThreadCount())
+    {
+        workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+            workers.emplace_back([this] { WorkerLoop(); });
+
+        Logger::Log(LogLevel::INFO, LogCategory::CORE,
+            "ThreadPool started with " + std::to_string(threadCount) + " workers");
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static size_t DefaultThreadCount()
+    {
+        unsigned int hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 0;
+    }
+
+    void Submit(std::function<void()> job)
+    {
+        if (workers.empty())
+        {
+            job();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        condition.notify_one();
+    }
+
+    // Shutdown only: the flag is never cleared, so the pool should be destroyed next.
+    // Jobs already queued still run so their owners' counters stay balanced,
+    // but long-running jobs should check IsCancelled() and return early
+    void CancelPending()
+    {
+        cancelled.store(true, std::memory_order_release);
+    }
+
+    bool IsCancelled() const { return cancelled.load(std::memory_order_acquire); }
+
+    // Splits [0, count) into chunks of chunkSize and runs func(begin, end) on each.
+    // Blocks until every chunk is done; the calling thread processes chunks too.
+    template<typename Func>
+    void ParallelFor(size_t count, size_t chunkSize, Func&& func)
+    {
+        if (count == 0)
+            return;
+
+        chunkSize = std::max<size_t>(chunkSize, 1);
+        size_t chunks = (count + chunkSize - 1) / chunkSize;
+
+        if (workers.empty() || chunks == 1)
+        {
+            func(size_t(0), count);
+            return;
+        }
+
+        // Helpers can be dequeued after the caller has returned, so they share only this
+        // state; func is touched only through a claimed chunk, which the caller waits for
+        struct Progress
+        {
+            std::atomic<size_t> nextChunk{0};
+            std::atomic<size_t> completedChunks{0};
+        };
+        auto progress = std::make_shared<Progress>();
+
+        auto drain = [progress, chunks, chunkSize, count, body = &func]()
+        {
+            size_t chunk;
+            while ((chunk = progress->nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunks)
+            {
+                size_t begin = chunk * chunkSize;
+                (*body)(begin, std::min(count, begin + chunkSize));
+                if (progress->completedChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks)
+                    progress->completedChunks.notify_all();
+            }
+        };
+
+        // Frame work jumps ahead of queued loads so it never waits behind them
+        size_t helpers = std::min(workers.size(), chunks - 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < helpers; i++)
+                jobs.push_front(drain);
+        }
+        condition.notify_all();
+
+        drain();
+
+        size_t done;
+        while ((done = progress->completedChunks.load(std::memory_order_acquire)) != chunks)
+            progress->completedChunks.wait(done);
+    }
+
+    size_t GetThreadCount() const { return workers.size(); }
+};
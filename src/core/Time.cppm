@@ -11,15 +11,16 @@ private:
     float lastFrame;
     float deltaTime;
     float timeScale;
+    float fixedDeltaTime;
 
 public:
     Time()
-        : currentFrame(0.0f), lastFrame(0.0f), deltaTime(0.0f), timeScale(1.0f)
+        : currentFrame(0.0f), lastFrame(0.0f), deltaTime(0.0f), timeScale(1.0f), fixedDeltaTime(0.0f)
     {}
     
     void Update()
     {
-        currentFrame = glfwGetTime();
+        currentFrame = fixedDeltaTime > 0.0f ? lastFrame + fixedDeltaTime : static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
     }
@@ -28,6 +29,10 @@ public:
     float GetTime() const { return currentFrame; }
     float GetTimeScale() const { return timeScale; }
     void SetTimeScale(float scale) { timeScale = scale; }
+
+    // Advances by a constant step per frame instead of wall-clock time; 0 restores real time
+    void SetFixedDeltaTime(float step) { fixedDeltaTime = step; }
+    float GetFixedDeltaTime() const { return fixedDeltaTime; }
     
     float GetFPS() const { return 1.0f / deltaTime; }
 };
\ No newline at end of file
@@ -4,6 +4,15 @@ module;
 #include <GLFW/glfw3.h>
 #include <string>
 
+#if defined(XENGINE_HAS_EGL)
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+
+    #ifndef EGL_PLATFORM_SURFACELESS_MESA
+        #define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+    #endif
+#endif
+
 export module XEngine.Core.Window;
 
 import XEngine.Core.Logger;
@@ -16,9 +25,106 @@ private:
     int height;
     std::string title;
 
+    // Offscreen context without any window system; rendering goes to framebuffer objects
+    bool headless;
+
+#if defined(XENGINE_HAS_EGL)
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    EGLContext eglContext = EGL_NO_CONTEXT;
+#endif
+
+    // EGL on the surfaceless platform (Mesa, works with llvmpipe and no GPU);
+    // falls back to the default display when the extension is missing
+    bool InitializeHeadless()
+    {
+#if defined(XENGINE_HAS_EGL)
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay)
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (eglDisplay == EGL_NO_DISPLAY)
+            eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        EGLint major = 0, minor = 0;
+        if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor))
+        {
+            Logger::Log(LogLevel::ERROR, "Failed to initialize EGL display");
+            return false;
+        }
+
+        if (!eglBindAPI(EGL_OPENGL_API))
+        {
+            Logger::Log(LogLevel::ERROR, "EGL: desktop OpenGL is not supported");
+            return false;
+        }
+
+        const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_NONE
+        };
+        EGLConfig config = nullptr;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0)
+            config = nullptr;       // EGL_KHR_no_config_context
+
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+        if (eglContext == EGL_NO_CONTEXT)
+        {
+            Logger::Log(LogLevel::ERROR, "Failed to create EGL OpenGL 3.3 core context");
+            return false;
+        }
+
+        if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext))
+        {
+            Logger::Log(LogLevel::ERROR, "EGL: surfaceless contexts are not supported");
+            return false;
+        }
+
+        if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+        {
+            Logger::Log(LogLevel::ERROR, "Failed to initialize GLAD");
+            return false;
+        }
+
+        Logger::Log(LogLevel::INFO, "Headless EGL " + std::to_string(major) + "." + std::to_string(minor) + 
+            " context created (" + std::to_string(width) + "x" + std::to_string(height) + ")");
+        Logger::Log(LogLevel::INFO, "OpenGL version: " + std::string((const char*)glGetString(GL_VERSION)) + 
+            ", renderer: " + std::string((const char*)glGetString(GL_RENDERER)));
+        return true;
+#else
+        Logger::Log(LogLevel::ERROR, "Headless mode needs EGL, which was not found at build time");
+        return false;
+#endif
+    }
+
+    void TerminateHeadless()
+    {
+#if defined(XENGINE_HAS_EGL)
+        if (eglDisplay != EGL_NO_DISPLAY)
+        {
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (eglContext != EGL_NO_CONTEXT)
+                eglDestroyContext(eglDisplay, eglContext);
+            eglTerminate(eglDisplay);
+            eglContext = EGL_NO_CONTEXT;
+            eglDisplay = EGL_NO_DISPLAY;
+            Logger::Log(LogLevel::INFO, "Headless context destroyed");
+        }
+#endif
+    }
+
 public:
-    Window(int width, int height, const std::string& title)
-        : window(nullptr), width(width), height(height), title(title) {}
+    Window(int width, int height, const std::string& title, bool headless = false)
+        : window(nullptr), width(width), height(height), title(title), headless(headless) {}
     ~Window()
     {
         Terminate();
@@ -31,6 +137,9 @@ public:
 
     bool Initialize()
     {
+        if (headless)
+            return InitializeHeadless();
+
     #if defined(__linux__)
         glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
     #endif
@@ -73,6 +182,12 @@ public:
 
     void Terminate()
     {
+        if (headless)
+        {
+            TerminateHeadless();
+            return;
+        }
+
         if (window)
         {
             glfwDestroyWindow(window);
@@ -86,17 +201,23 @@ public:
     
     bool ShouldClose() const
     {
-        return glfwWindowShouldClose(window);
+        return !headless && glfwWindowShouldClose(window);
     }
 
+    // Headless frames end with glFinish so each frame's GPU work is complete
+    // before the next one starts, and frame times do not depend on queue depth
     void SwapBuffers()
     {
-        glfwSwapBuffers(window);
+        if (headless)
+            glFinish();
+        else
+            glfwSwapBuffers(window);
     }
 
     void PollEvents()
     {
-        glfwPollEvents();
+        if (!headless)
+            glfwPollEvents();
     }
     
     void SetFramebufferSizeCallback(GLFWframebuffersizefun callback)
@@ -127,6 +248,7 @@ public:
     void SetSize(int w, int h) { width = w;height = h; }
 
     GLFWwindow* GetGLFWWindow() { return window; }
+    bool IsHeadless() const { return headless; }
     int GetWidth() const { return width; }
     int GetHeight() const { return height; }
     float GetAspectRatio() const { return static_cast<float>(width) / static_cast<float>(height); }
@@ -3,6 +3,7 @@ module;
 #include <string>
 #include <chrono>
 #include <print>
+#include <cstdio>
 
 export module XEngine.Core.Logging.ConsoleLogger;
 
@@ -33,6 +34,11 @@ public:
                         data.m.c_str());
     }
 
+    void flush() override
+    {
+        std::fflush(stdout);
+    }
+
 private:
     const char* levelToString(LogLevel lvl)
     {
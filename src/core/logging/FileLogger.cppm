@@ -5,6 +5,9 @@ module;
 #include <fstream>
 #include <filesystem>
 #include <format>
+#include <iterator>
+#include <ctime>
+#include <utility>
 
 export module XEngine.Core.Logging.FileLogger;
 
@@ -19,14 +22,18 @@ export class FileLogger : public ILogSink
     std::string logPath;
     std::ofstream file;
 
+    std::string line;               // reused for every record
+    std::time_t cachedSecond = -1;  // wall-clock second that cachedTime was formatted for
+    std::string cachedTime;
+
     bool isShuttingDown = false;
 
 public:
-    FileLogger()
-        : folderName("../log")
+    explicit FileLogger(std::string folder = "../log")
+        : folderName(std::move(folder))
     {
-        if (!fs::exists("../log"))
-            fs::create_directory(folderName);
+        if (!fs::exists(folderName))
+            fs::create_directories(folderName);
     }
 
     ~FileLogger() 
@@ -51,26 +58,53 @@ public:
         
         if (file.is_open())
         {
+            line.clear();
             if (data.showOrigin)
-                file << std::format("[{}] [{}] [{}] {} ({}:{})", 
-                        timeStr, 
+                std::format_to(std::back_inserter(line), "[{}] [{}] [{}] {} ({}:{})\n", 
+                        RecordTime(data.timestamp), 
                         lvl, 
                         cat,
                         data.m, 
                         data.f, 
-                        data.line) << std::endl;
+                        data.line);
             else
-                file << std::format("[{}] [{}] [{}] {}", 
-                        timeStr, 
+                std::format_to(std::back_inserter(line), "[{}] [{}] [{}] {}\n", 
+                        RecordTime(data.timestamp), 
                         lvl, 
                         cat,
-                        data.m) << std::endl;
+                        data.m);
 
-            file.flush();
+            // Flushing is left to flush(): once per record when synchronous, once per batch when async
+            file.write(line.data(), static_cast<std::streamsize>(line.size()));
         }
     }
 
+    void flush() override
+    {
+        if (file.is_open())
+            file.flush();
+    }
+
 private:
+    // HH:MM:SS.mmm; the localtime part only changes once a second
+    std::string RecordTime(const std::chrono::system_clock::time_point& tp)
+    {
+        std::time_t second = std::chrono::system_clock::to_time_t(tp);
+        if (second != cachedSecond)
+        {
+            std::tm tm_snapshot;
+            localtime_r(&second, &tm_snapshot);
+
+            char buffer[16];
+            std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &tm_snapshot);
+            cachedTime = buffer;
+            cachedSecond = second;
+        }
+
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()) % 1000;
+        return std::format("{}.{:03}", cachedTime, ms.count());
+    }
+
     void OpenLogFile(const LogData& data)
     {
         timeStr = FormatTime(data.timestamp);
@@ -1,11 +1,26 @@
 module;
 
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <cstring>
+#include <cstdint>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
 #include <source_location>
 
+// Calls below this severity are compiled out (see GetLogSeverity)
+#ifndef XENGINE_LOG_MIN_SEVERITY
+    #define XENGINE_LOG_MIN_SEVERITY 0
+#endif
+
 export module XEngine.Core.Logger;
 
 export enum class LogLevel
@@ -19,7 +34,7 @@ export enum class LogLevel
     // TRACE
 };
 
-export enum class LogCategory 
+export enum class LogCategory
 {
     CORE,
     RENDERING,
@@ -27,6 +42,26 @@ export enum class LogCategory
     OTHER
 };
 
+// LogLevel is not ordered by importance; filtering goes through this
+export constexpr int GetLogSeverity(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::DEBUG:    return 0;
+        case LogLevel::INPUT:    return 1;
+        case LogLevel::INFO:     return 2;
+        case LogLevel::WARNING:  return 3;
+        case LogLevel::ERROR:    return 4;
+        case LogLevel::CRITICAL: return 5;
+        default:                 return 2;
+    }
+}
+
+export constexpr int LOG_COMPILED_MIN_SEVERITY = XENGINE_LOG_MIN_SEVERITY;
+
+export template<LogLevel Level>
+constexpr bool IsLogCompiledIn = GetLogSeverity(Level) >= LOG_COMPILED_MIN_SEVERITY;
+
 export struct LogData
 {
     LogLevel lvl;
@@ -45,6 +80,140 @@ export class ILogSink
 public:
     virtual ~ILogSink() = default;
     virtual void write(const LogData& data) = 0;
+
+    // Called after each batch in async mode and after every record otherwise
+    virtual void flush() {}
+};
+
+export enum class LogOverflowPolicy
+{
+    DROP,       // lose the record, never stall the caller
+    BLOCK       // wait for the backend to make room
+};
+
+export struct AsyncLogConfig
+{
+    size_t bufferBytes = 64 * 1024;     // per producing thread, rounded up to a power of two
+    LogOverflowPolicy overflow = LogOverflowPolicy::DROP;
+    std::chrono::milliseconds flushInterval{ 100 };
+};
+
+export struct LogStats
+{
+    uint64_t written = 0;   // records handed to the sinks by the backend
+    uint64_t dropped = 0;   // lost to full buffers (DROP policy)
+    uint64_t blocked = 0;   // calls that had to wait for space (BLOCK policy)
+};
+
+// Single-producer single-consumer byte ring holding variable-sized records.
+// Positions grow monotonically; a record never wraps, the tail of the buffer is
+// skipped with a padding record instead.
+class LogRing
+{
+public:
+    struct RecordHeader
+    {
+        uint32_t    size;       // whole record including the text, 8-byte multiple
+        uint8_t     flags;
+        uint8_t     level;
+        uint8_t     category;
+        uint8_t     reserved;
+        int32_t     line;
+        uint32_t    length;
+        const char* file;       // static storage (source_location or literal)
+        int64_t     timestamp;  // system_clock ticks
+    };
+
+    static constexpr uint8_t FLAG_PADDING = 1;
+    static constexpr uint8_t FLAG_ORIGIN = 2;
+
+    static_assert(sizeof(RecordHeader) == 32);
+
+    explicit LogRing(size_t bytes)
+    {
+        capacity = 1024;
+        while (capacity < bytes)
+            capacity <<= 1;
+        buffer = std::make_unique<uint8_t[]>(capacity);
+    }
+
+    size_t GetCapacity() const { return capacity; }
+    size_t GetMaxText() const { return capacity / 2 - sizeof(RecordHeader); }
+
+    size_t GetUsed() const
+    {
+        return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+    }
+
+    // Producer thread only
+    bool TryPush(const RecordHeader& header, const char* text)
+    {
+        const size_t need = (sizeof(RecordHeader) + header.length + 7) & ~size_t(7);
+        const size_t write = head.load(std::memory_order_relaxed);
+        const size_t read = tail.load(std::memory_order_acquire);
+
+        const size_t offset = write & (capacity - 1);
+        const size_t padding = capacity - offset < need ? capacity - offset : 0;
+        if (capacity - (write - read) < padding + need)
+            return false;
+
+        size_t position = write;
+        if (padding)
+        {
+            // Only the first 8 bytes are guaranteed to fit, which covers size and flags
+            uint32_t size = static_cast<uint32_t>(padding);
+            std::memcpy(&buffer[offset], &size, sizeof(size));
+            buffer[offset + 4] = FLAG_PADDING;
+            position += padding;
+        }
+
+        uint8_t* at = &buffer[position & (capacity - 1)];
+        RecordHeader stored = header;
+        stored.size = static_cast<uint32_t>(need);
+        std::memcpy(at, &stored, sizeof(stored));
+        std::memcpy(at + sizeof(stored), text, header.length);
+
+        head.store(position + need, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    template<typename Fn>
+    size_t Drain(Fn&& fn)
+    {
+        size_t read = tail.load(std::memory_order_relaxed);
+        const size_t write = head.load(std::memory_order_acquire);
+        size_t count = 0;
+
+        while (read < write)
+        {
+            const uint8_t* at = &buffer[read & (capacity - 1)];
+            uint32_t size;
+            std::memcpy(&size, at, sizeof(size));
+
+            if (!(at[4] & FLAG_PADDING))
+            {
+                RecordHeader header;
+                std::memcpy(&header, at, sizeof(header));
+                fn(header, reinterpret_cast<const char*>(at + sizeof(header)));
+                count++;
+            }
+
+            read += size;
+        }
+
+        tail.store(read, std::memory_order_release);
+        return count;
+    }
+
+    std::atomic<bool> retired{ false };
+
+private:
+    std::unique_ptr<uint8_t[]> buffer;
+    size_t capacity;
+
+    alignas(64) std::atomic<size_t> head{ 0 };
+    alignas(64) std::atomic<size_t> tail{ 0 };
 };
 
 export class Logger
@@ -70,83 +239,438 @@ public:
         sinks().clear();
     }
 
-    static void Log(LogLevel level, const std::string& message)
+    static std::vector<ILogSink*> GetSinks()
     {
         std::lock_guard<std::mutex> lock(logMutex());
-        
-        LogData data{
-            level, 
-            LogCategory::OTHER, 
-            message, 
-            "", 
-            0, 
-            false, 
-            std::chrono::system_clock::now()
-        };
-        
-        for (auto* sink : sinks())
-            if (sink)
-                sink->write(data);
+        return sinks();
     }
 
+    // ───── Filtering ─────
+
+    static void SetMinLevel(LogLevel level)
+    {
+        minSeverity().store(GetLogSeverity(level), std::memory_order_relaxed);
+    }
+
+    static LogLevel GetMinLevel()
+    {
+        int severity = minSeverity().load(std::memory_order_relaxed);
+        for (LogLevel level : { LogLevel::DEBUG, LogLevel::INPUT, LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL })
+            if (GetLogSeverity(level) == severity)
+                return level;
+        return LogLevel::DEBUG;
+    }
+
+    static void SetCategoryEnabled(LogCategory cat, bool enabled)
+    {
+        uint32_t bit = 1u << static_cast<uint32_t>(cat);
+        if (enabled)
+            categoryMask().fetch_or(bit, std::memory_order_relaxed);
+        else
+            categoryMask().fetch_and(~bit, std::memory_order_relaxed);
+    }
+
+    static bool IsEnabled(LogLevel level, LogCategory cat)
+    {
+        int severity = GetLogSeverity(level);
+        return severity >= LOG_COMPILED_MIN_SEVERITY
+            && severity >= minSeverity().load(std::memory_order_relaxed)
+            && (categoryMask().load(std::memory_order_relaxed) & (1u << static_cast<uint32_t>(cat)));
+    }
+
+    // ───── Logging ─────
+
+    static void Log(LogLevel level, const std::string& message)
+    {
+        if (IsEnabled(level, LogCategory::OTHER))
+            Dispatch(level, LogCategory::OTHER, message, nullptr, 0);
+    }
 
     static void Log(LogLevel level, const std::string& message, bool showOrigin, const std::source_location& loc = std::source_location::current())
     {
+        if (IsEnabled(level, LogCategory::OTHER))
+            Dispatch(level, LogCategory::OTHER, message, showOrigin ? stripProjectRoot(loc.file_name()) : nullptr,
+                showOrigin ? int(loc.line()) : 0);
+    }
+
+    static void Log(LogLevel level, LogCategory cat, const std::string& message, bool showOrigin = false)
+    {
+        if (IsEnabled(level, cat))
+            Dispatch(level, cat, message, showOrigin ? __FILE__ : nullptr, showOrigin ? __LINE__ : 0);
+    }
+
+    // The message is only built when the record passes both filters; calls below
+    // XENGINE_LOG_MIN_SEVERITY compile to nothing. For hot paths:
+    //     Logger::Log<LogLevel::DEBUG>(LogCategory::RENDERING, [&] { return "..." + std::to_string(n); });
+    template<LogLevel Level, typename MessageFn>
+    static void Log(LogCategory cat, MessageFn&& makeMessage)
+    {
+        if constexpr (IsLogCompiledIn<Level>)
+        {
+            if (IsEnabled(Level, cat))
+                Dispatch(Level, cat, std::forward<MessageFn>(makeMessage)(), nullptr, 0);
+        }
+    }
+
+    // ───── Async mode ─────
+
+    // Starts the background writer. From here on callers only copy the record
+    // into their thread's ring buffer. Call from the main thread.
+    static void StartAsync(const AsyncLogConfig& config = {})
+    {
+        AsyncState& state = asyncState();
+        if (state.running.load())
+            return;
+
+        state.config = config;
+        state.stop.store(false);
+        state.generation.fetch_add(1);
+        state.running.store(true);
+        state.worker = std::thread(BackendLoop);
+    }
+
+    // Drains everything still queued and returns to synchronous writes. Other
+    // threads should have stopped logging.
+    static void StopAsync()
+    {
+        AsyncState& state = asyncState();
+        if (!state.running.load())
+            return;
+
+        // Callers that already saw running == true finish their push before the
+        // backend's last pass; later ones write synchronously
+        state.running.store(false);
+        while (state.pushers.load() != 0)
+            std::this_thread::yield();
+
+        state.stop.store(true);
+        Wake();
+        state.worker.join();
+
+        std::vector<LogData> batch;
+        DrainRings(batch);
+        WriteBatch(batch);
+
+        std::lock_guard<std::mutex> lock(state.ringsMutex);
+        state.rings.clear();
+    }
+
+    static bool IsAsync() { return asyncState().running.load(std::memory_order_acquire); }
+
+    // The config passed to the last StartAsync, so callers can restart with the same settings
+    static AsyncLogConfig GetAsyncConfig() { return asyncState().config; }
+
+    // Blocks until everything logged before the call has reached the sinks
+    static void Flush()
+    {
+        AsyncState& state = asyncState();
+        if (!state.running.load() || std::this_thread::get_id() == state.worker.get_id())
+            return;
+
+        uint64_t ticket = state.flushRequested.fetch_add(1) + 1;
+        Wake();
+
+        std::unique_lock<std::mutex> lock(state.wakeMutex);
+        state.flushed.wait(lock, [&]()
+        {
+            return state.flushCompleted.load() >= ticket || !state.running.load();
+        });
+    }
+
+    static LogStats GetStats()
+    {
+        AsyncState& state = asyncState();
+        return { state.written.load(), state.dropped.load(), state.blocked.load() };
+    }
+
+private:
+    struct AsyncState
+    {
+        AsyncLogConfig config;
+
+        std::atomic<bool> running{ false };
+        std::atomic<bool> stop{ false };
+        std::atomic<uint32_t> pushers{ 0 };     // threads inside PushAsync
+        std::atomic<bool> wakeRequested{ false };
+        std::atomic<uint64_t> generation{ 0 };
+
+        std::mutex ringsMutex;
+        std::vector<std::shared_ptr<LogRing>> rings;
+
+        std::thread worker;
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        std::condition_variable flushed;
+
+        std::atomic<uint64_t> flushRequested{ 0 };
+        std::atomic<uint64_t> flushCompleted{ 0 };
+
+        std::atomic<uint64_t> written{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<uint64_t> blocked{ 0 };
+    };
+
+    // Keeps this thread's ring alive and marks it for removal when the thread exits
+    struct ThreadRing
+    {
+        std::shared_ptr<LogRing> ring;
+        uint64_t generation = 0;
+
+        ~ThreadRing()
+        {
+            if (ring)
+                ring->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    static void Dispatch(LogLevel level, LogCategory cat, std::string_view message, const char* file, int line)
+    {
+        if (IsAsync() && PushAsync(level, cat, message, file, line))
+        {
+            if (level == LogLevel::CRITICAL)
+                Flush();
+            return;
+        }
+
         std::lock_guard<std::mutex> lock(logMutex());
 
         LogData data{
             level,
-            LogCategory::OTHER,
-            message,
-            showOrigin ? stripProjectRoot(loc.file_name()) : "",
-            showOrigin ? int(loc.line()) : 0,
-            showOrigin,
+            cat,
+            std::string(message),
+            file ? file : "",
+            line,
+            file != nullptr,
             std::chrono::system_clock::now()
         };
 
         for (auto* sink : sinks())
+        {
             if (sink)
+            {
                 sink->write(data);
+                sink->flush();
+            }
+        }
     }
 
-    static void Log(LogLevel level, LogCategory cat, const std::string& message, bool showOrigin = false)
+    static LogRing& GetThreadRing()
     {
-        std::lock_guard<std::mutex> lock(logMutex());
-        
-        LogData data{
-            level, 
-            cat, 
-            message, 
-            showOrigin ? __FILE__ : "", 
-            showOrigin ? __LINE__ : 0, 
-            showOrigin, 
-            std::chrono::system_clock::now()
+        thread_local ThreadRing local;
+
+        AsyncState& state = asyncState();
+        uint64_t generation = state.generation.load(std::memory_order_relaxed);
+        if (!local.ring || local.generation != generation)
+        {
+            if (local.ring)
+                local.ring->retired.store(true, std::memory_order_release);
+
+            local.ring = std::make_shared<LogRing>(state.config.bufferBytes);
+            local.generation = generation;
+
+            std::lock_guard<std::mutex> lock(state.ringsMutex);
+            state.rings.push_back(local.ring);
+        }
+        return *local.ring;
+    }
+
+    // Returns false when async mode is stopping; the caller then writes synchronously
+    static bool PushAsync(LogLevel level, LogCategory cat, std::string_view message, const char* file, int line)
+    {
+        AsyncState& state = asyncState();
+
+        // Announce the push before checking running; StopAsync clears running and then
+        // waits for pushers, so one of the two always sees the other
+        struct PusherScope
+        {
+            std::atomic<uint32_t>& pushers;
+            ~PusherScope() { pushers.fetch_sub(1); }
         };
-        
-        for (auto* sink : sinks())
-            if (sink)
-                sink->write(data);
+        state.pushers.fetch_add(1);
+        PusherScope scope{ state.pushers };
+
+        if (!state.running.load())
+            return false;
+
+        LogRing& ring = GetThreadRing();
+
+        LogRing::RecordHeader header{};
+        header.flags = file ? LogRing::FLAG_ORIGIN : 0;
+        header.level = static_cast<uint8_t>(level);
+        header.category = static_cast<uint8_t>(cat);
+        header.line = line;
+        header.length = static_cast<uint32_t>(std::min(message.size(), ring.GetMaxText()));
+        header.file = file;
+        header.timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+
+        if (!ring.TryPush(header, message.data()))
+        {
+            if (state.config.overflow == LogOverflowPolicy::DROP)
+            {
+                state.dropped.fetch_add(1, std::memory_order_relaxed);
+                Wake();
+                return true;
+            }
+
+            state.blocked.fetch_add(1, std::memory_order_relaxed);
+            bool pushed = false;
+            do
+            {
+                Wake();
+                std::this_thread::yield();
+                pushed = ring.TryPush(header, message.data());
+            } while (!pushed && state.running.load(std::memory_order_relaxed));
+
+            if (!pushed)
+                return false;
+        }
+
+        // Wake the backend early rather than letting the ring fill up
+        if (ring.GetUsed() > ring.GetCapacity() / 2)
+            Wake();
+        return true;
     }
 
-private:
+    static void Wake()
+    {
+        AsyncState& state = asyncState();
+        if (!state.wakeRequested.exchange(true, std::memory_order_acq_rel))
+        {
+            // Pass through the mutex so the notify cannot land between the
+            // backend's predicate check and its wait
+            { std::lock_guard<std::mutex> lock(state.wakeMutex); }
+            state.wake.notify_one();
+        }
+    }
+
+    static void BackendLoop()
+    {
+        AsyncState& state = asyncState();
+        std::vector<LogData> batch;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(state.wakeMutex);
+                state.wake.wait_for(lock, state.config.flushInterval, [&]()
+                {
+                    return state.wakeRequested.load() || state.stop.load();
+                });
+            }
+            state.wakeRequested.store(false);
+
+            bool stopping = state.stop.load();
+            uint64_t flushTarget = state.flushRequested.load();
+
+            DrainRings(batch);
+            WriteBatch(batch);
+
+            {
+                std::lock_guard<std::mutex> lock(state.wakeMutex);
+                state.flushCompleted.store(flushTarget);
+            }
+            state.flushed.notify_all();
+
+            if (stopping)
+                break;
+        }
+
+        state.flushed.notify_all();
+    }
+
+    static void WriteBatch(std::vector<LogData>& batch)
+    {
+        if (batch.empty())
+            return;
+
+        // Rings are per thread; merge them back into one timeline
+        std::stable_sort(batch.begin(), batch.end(), [](const LogData& a, const LogData& b)
+        {
+            return a.timestamp < b.timestamp;
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(logMutex());
+            for (auto* sink : sinks())
+            {
+                if (!sink)
+                    continue;
+                for (const auto& data : batch)
+                    sink->write(data);
+                sink->flush();
+            }
+        }
+
+        asyncState().written.fetch_add(batch.size(), std::memory_order_relaxed);
+        batch.clear();
+    }
+
+    static void DrainRings(std::vector<LogData>& batch)
+    {
+        AsyncState& state = asyncState();
+        std::lock_guard<std::mutex> lock(state.ringsMutex);
+
+        for (auto it = state.rings.begin(); it != state.rings.end(); )
+        {
+            LogRing& ring = **it;
+            bool retired = ring.retired.load(std::memory_order_acquire);
+
+            ring.Drain([&](const LogRing::RecordHeader& header, const char* text)
+            {
+                bool origin = header.flags & LogRing::FLAG_ORIGIN;
+                batch.push_back({
+                    static_cast<LogLevel>(header.level),
+                    static_cast<LogCategory>(header.category),
+                    std::string(text, header.length),
+                    origin ? header.file : "",
+                    header.line,
+                    origin,
+                    std::chrono::system_clock::time_point(std::chrono::system_clock::duration(header.timestamp))
+                });
+            });
+
+            // The thread is gone and everything it wrote has been read
+            if (retired && ring.GetUsed() == 0)
+                it = state.rings.erase(it);
+            else
+                ++it;
+        }
+    }
 
     static const char* stripProjectRoot(const char* file)
     {
-        constexpr const char* ROOT = "XEngine/"; 
+        constexpr const char* ROOT = "XEngine/";
         const char* pos = std::strstr(file, ROOT);
         return pos ? pos : file;
     }
 
-    static std::vector<ILogSink*>& sinks() 
+    static std::vector<ILogSink*>& sinks()
     {
         static std::vector<ILogSink*> instance;
         return instance;
     }
 
-    static std::mutex& logMutex() 
+    static std::mutex& logMutex()
     {
         static std::mutex instance;
         return instance;
     }
 
+    static std::atomic<int>& minSeverity()
+    {
+        static std::atomic<int> instance{ 0 };
+        return instance;
+    }
+
+    static std::atomic<uint32_t>& categoryMask()
+    {
+        static std::atomic<uint32_t> instance{ ~0u };
+        return instance;
+    }
+
+    static AsyncState& asyncState()
+    {
+        static AsyncState instance;
+        return instance;
+    }
 };
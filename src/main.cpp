@@ -1,12 +1,22 @@
 import XEngine.Engine;
+import XEngine.Benchmark;
 import XEngine.Core.Logger;
 
-int main() 
+int main(int argc, char** argv) 
 {
 #if defined (__WIN32__)
     exit()
 #endif
 
+    if (Benchmark::IsRequested(argc, argv))
+    {
+        BenchmarkConfig config;
+        if (!Benchmark::ParseArguments(argc, argv, config))
+            return 2;
+
+        return Benchmark::Run(config);
+    }
+
     Engine e(1020, 800, "XEngine - Best Engine");
     
     if (!e.Initialize()) 
@@ -19,4 +29,4 @@ int main()
     e.Shutdown();
     
     return 0;
-}
\ No newline at end of file
+}
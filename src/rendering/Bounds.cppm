@@ -0,0 +1,162 @@
+module;
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <limits>
+
+export module XEngine.Rendering.Bounds;
+
+export struct AABB
+{
+    glm::vec3 min{ std::numeric_limits<float>::max() };
+    glm::vec3 max{ std::numeric_limits<float>::lowest() };
+
+    AABB() = default;
+    AABB(const glm::vec3& mn, const glm::vec3& mx) : min(mn), max(mx) {}
+
+    bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+    void Expand(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+    // Half surface area, the cost metric used when building the BVH
+    float GetArea() const
+    {
+        glm::vec3 d = max - min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    bool Contains(const AABB& other) const
+    {
+        return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+    }
+
+    bool Overlaps(const AABB& other) const
+    {
+        return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+    }
+
+    AABB Fattened(float margin) const
+    {
+        return { min - glm::vec3(margin), max + glm::vec3(margin) };
+    }
+
+    static AABB Union(const AABB& a, const AABB& b)
+    {
+        return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+    }
+
+    // Bounds of this box after an affine transform (Arvo's method)
+    AABB Transformed(const glm::mat4& m) const
+    {
+        glm::vec3 center = glm::vec3(m * glm::vec4(GetCenter(), 1.0f));
+        glm::vec3 extents = GetExtents();
+
+        glm::mat3 absolute = glm::mat3(glm::abs(glm::vec3(m[0])), glm::abs(glm::vec3(m[1])), glm::abs(glm::vec3(m[2])));
+        glm::vec3 newExtents = absolute * extents;
+
+        return { center - newExtents, center + newExtents };
+    }
+
+    static AABB FromSphere(const glm::vec3& center, float radius)
+    {
+        return { center - glm::vec3(radius), center + glm::vec3(radius) };
+    }
+};
+
+export struct Ray
+{
+    glm::vec3 origin{ 0.0f };
+    glm::vec3 direction{ 0.0f, 0.0f, -1.0f };
+
+    // Slab test. Returns the entry distance, or a negative value on a miss.
+    float Intersect(const AABB& box, float maxDistance = std::numeric_limits<float>::max()) const
+    {
+        glm::vec3 inv = 1.0f / direction;
+        glm::vec3 t0 = (box.min - origin) * inv;
+        glm::vec3 t1 = (box.max - origin) * inv;
+
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+
+        return enter <= exit ? enter : -1.0f;
+    }
+};
+
+export enum class FrustumTest
+{
+    OUTSIDE,
+    INTERSECTS,
+    INSIDE
+};
+
+export struct Frustum
+{
+    glm::vec4 planes[6]; // xyz normal pointing inwards, w distance
+
+    Frustum() = default;
+
+    // Gribb-Hartmann extraction from projection * view
+    explicit Frustum(const glm::mat4& viewProjection)
+    {
+        glm::mat4 m = glm::transpose(viewProjection);
+
+        planes[0] = m[3] + m[0]; // left
+        planes[1] = m[3] - m[0]; // right
+        planes[2] = m[3] + m[1]; // bottom
+        planes[3] = m[3] - m[1]; // top
+        planes[4] = m[3] + m[2]; // near
+        planes[5] = m[3] - m[2]; // far
+
+        for (auto& plane : planes)
+            plane /= glm::length(glm::vec3(plane));
+    }
+
+    FrustumTest Test(const AABB& box) const
+    {
+        glm::vec3 center = box.GetCenter();
+        glm::vec3 extents = box.GetExtents();
+
+        FrustumTest result = FrustumTest::INSIDE;
+        for (const auto& plane : planes)
+        {
+            glm::vec3 normal = glm::vec3(plane);
+            float distance = glm::dot(normal, center) + plane.w;
+            float radius = glm::dot(extents, glm::abs(normal));
+
+            if (distance < -radius)
+                return FrustumTest::OUTSIDE;
+            if (distance < radius)
+                result = FrustumTest::INTERSECTS;
+        }
+        return result;
+    }
+
+    bool TestSphere(const glm::vec3& center, float radius) const
+    {
+        for (const auto& plane : planes)
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false;
+        return true;
+    }
+
+    // 0 inside; outside, the largest distance past any plane, which never
+    // overestimates the true distance to the frustum
+    float DistanceOutside(const glm::vec3& point) const
+    {
+        float distance = 0.0f;
+        for (const auto& plane : planes)
+            distance = glm::max(distance, -(glm::dot(glm::vec3(plane), point) + plane.w));
+        return distance;
+    }
+};
@@ -1,10 +1,20 @@
 module;
 
+#include <algorithm>
 #include <cstddef>
 #include <glad/glad.h>
 
 export module XEngine.Rendering.Buffer;
 
+import XEngine.Rendering.MeshData;
+import XEngine.Core.Profiler;
+
+void CountUpload(size_t bytes)
+{
+    Profiler::Count(ProfileCounter::BUFFER_UPLOADS);
+    Profiler::Count(ProfileCounter::UPLOAD_BYTES, bytes);
+}
+
 // ================= VertexBuffer =================
 export class VertexBuffer
 {
@@ -36,17 +46,52 @@ public:
     {
         Bind();
         glBufferData(GL_ARRAY_BUFFER, size, data, usage);
+
+        // A null pointer only (re)allocates or orphans storage; nothing is transferred
+        if (data)
+            CountUpload(size);
+    }
+
+    void SetSubData(const void* data, size_t size, size_t offset = 0)
+    {
+        Bind();
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+        CountUpload(size);
     }
 
     unsigned int GetID() const { return VBO; }
 };
 
+// ================= InstanceBuffer =================
+// Long-lived streaming buffer for per-instance attributes. Storage only grows;
+// each upload orphans the old storage so the driver never waits on the GPU.
+export class InstanceBuffer
+{
+private:
+    VertexBuffer buffer;
+    size_t capacity = 0;
+
+public:
+    void Upload(const void* data, size_t size)
+    {
+        if (size > capacity)
+            capacity = std::max(size, capacity * 2);
+
+        buffer.SetData(nullptr, capacity, GL_STREAM_DRAW);
+        buffer.SetSubData(data, size);
+    }
+
+    const VertexBuffer& GetBuffer() const { return buffer; }
+    size_t GetCapacity() const { return capacity; }
+};
+
 // ================= IndexBuffer =================
 export class IndexBuffer
 {
 private:
     unsigned int EBO = 0;
     unsigned int count = 0;
+    GLenum type = GL_UNSIGNED_INT;
 
 public:
     IndexBuffer()
@@ -71,21 +116,81 @@ public:
 
     void SetData(const unsigned int* data, unsigned int cnt,
                  GLenum usage = GL_STATIC_DRAW)
+    {
+        SetData(data, cnt, GL_UNSIGNED_INT, usage);
+    }
+
+    // type is GL_UNSIGNED_INT or GL_UNSIGNED_SHORT
+    void SetData(const void* data, unsigned int cnt, GLenum indexType,
+                 GLenum usage = GL_STATIC_DRAW)
     {
         count = cnt;
+        type = indexType;
         Bind();
         glBufferData(
             GL_ELEMENT_ARRAY_BUFFER,
-            count * sizeof(unsigned int),
+            count * GetIndexSize(),
             data,
             usage
         );
+        if (data)
+            CountUpload(count * GetIndexSize());
     }
 
+    size_t GetIndexSize() const { return type == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int); }
+    GLenum GetType() const { return type; }
     unsigned int GetCount() const { return count; }
     unsigned int GetID() const { return EBO; }
 };
 
+// ================= UniformBuffer =================
+export class UniformBuffer
+{
+private:
+    unsigned int UBO = 0;
+    size_t size = 0;
+
+public:
+    UniformBuffer(size_t size, unsigned int binding)
+        : size(size)
+    {
+        glGenBuffers(1, &UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    ~UniformBuffer()
+    {
+        glDeleteBuffers(1, &UBO);
+    }
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    void Bind() const
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    }
+
+    void Unbind() const
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void SetData(const void* data, size_t dataSize, size_t offset = 0)
+    {
+        Bind();
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+        CountUpload(dataSize);
+        Unbind();
+    }
+
+    size_t GetSize() const { return size; }
+    unsigned int GetID() const { return UBO; }
+};
+
 // ================= VertexArray =================
 export class VertexArray
 {
@@ -134,5 +239,59 @@ public:
         );
     }
 
+    void AddAttribute(const VertexAttribute& attribute, int stride)
+    {
+        Bind();
+        glEnableVertexAttribArray(attribute.index);
+
+        if (attribute.integer)
+            glVertexAttribIPointer(
+                attribute.index,
+                attribute.components,
+                attribute.type,
+                stride,
+                reinterpret_cast<void*>(attribute.offset)
+            );
+        else
+            glVertexAttribPointer(
+                attribute.index,
+                attribute.components,
+                attribute.type,
+                attribute.normalized ? GL_TRUE : GL_FALSE,
+                stride,
+                reinterpret_cast<void*>(attribute.offset)
+            );
+    }
+
+    // The vertex buffer must be bound to GL_ARRAY_BUFFER
+    void SetLayout(const VertexLayout& layout)
+    {
+        for (const auto& attribute : layout.attributes)
+            AddAttribute(attribute, layout.stride);
+    }
+
+    // Unlike AddAttribute this does not bind the VAO: it is re-pointed for every
+    // instanced batch, so the caller is expected to have it bound already.
+    void AddInstanceAttribute(
+        unsigned int index,
+        int size,
+        GLenum type,
+        bool normalized,
+        int stride,
+        size_t offset
+    )
+    {
+        glEnableVertexAttribArray(index);
+        glVertexAttribPointer(
+            index,
+            size,
+            type,
+            normalized ? GL_TRUE : GL_FALSE,
+            stride,
+            reinterpret_cast<void*>(offset)
+        );
+        glVertexAttribDivisor(index, 1);
+    }
+
     unsigned int GetID() const { return VAO; }
 };
@@ -5,12 +5,15 @@ module;
 #include <vector>
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 export module XEngine.Rendering.GPUMesh;
 
 import XEngine.Rendering.Buffer;    
+import XEngine.Rendering.Bounds;
 import XEngine.Rendering.MeshData; 
 import XEngine.Core.Logger;
+import XEngine.Core.Profiler;
 
 export class GPUMesh
 {
@@ -22,16 +25,26 @@ private:
     size_t indexCount = 0;
     size_t vertexCount = 0;
     bool   usedIndices = false;
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t vertexBytes = 0;     // vertex + index buffer sizes
+
+    AABB   bounds;     // object space, from the vertex positions
 
 public:
     GPUMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
     {
         usedIndices = true;
         indexCount = indices.size();
+        vertexCount = vertices.size();
+
+        for (const auto& vertex : vertices)
+            bounds.Expand(vertex.Position);
 
-        Logger::Log(LogLevel::INFO, "GPUMesh created with " + 
-            std::to_string(vertices.size()) + " vertices and " + 
-            std::to_string(indexCount) + " indices");
+        Logger::Log<LogLevel::DEBUG>(LogCategory::RENDERING, [&]() 
+        {
+            return "GPUMesh created with " + std::to_string(vertices.size()) + " vertices and " + 
+                std::to_string(indexCount) + " indices";
+        });
 
         VAO = std::make_unique<VertexArray>();
         VBO = std::make_unique<VertexBuffer>();
@@ -45,15 +58,13 @@ public:
         EBO->Bind();
         EBO->SetData(indices.data(), static_cast<unsigned int>(indices.size()), GL_STATIC_DRAW);
 
-        VAO->AddAttribute(0, 3, GL_FLOAT, false, sizeof(Vertex), 0);                          // Position
-        VAO->AddAttribute(1, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, Normal));   // Normal
-        VAO->AddAttribute(2, 2, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, TexCoords));// TexCoords
-        VAO->AddAttribute(3, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, Tangent)); // Tangent
-        VAO->AddAttribute(4, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, Bitangent));// Bitangent
+        vertexBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+
+        VAO->SetLayout(VertexLayout::Standard());
 
         VAO->Unbind();
 
-        Logger::Log(LogLevel::INFO, "GPUMesh attributes configured successfully");
+        Logger::Log<LogLevel::DEBUG>(LogCategory::RENDERING, []() { return std::string("GPUMesh attributes configured successfully"); });
     }
 
     GPUMesh(const float* data, size_t dataSize, int stride)
@@ -61,13 +72,20 @@ public:
         usedIndices = false;
         vertexCount = dataSize / (stride * sizeof(float));
 
-        Logger::Log(LogLevel::INFO, "GPUMesh created from raw data: " + 
-            std::to_string(vertexCount) + " vertices, stride=" + std::to_string(stride));
+        for (size_t i = 0; i < vertexCount; i++)
+            bounds.Expand(glm::vec3(data[i * stride], data[i * stride + 1], data[i * stride + 2]));
+
+        Logger::Log<LogLevel::DEBUG>(LogCategory::RENDERING, [&]() 
+        {
+            return "GPUMesh created from raw data: " + std::to_string(vertexCount) + " vertices, stride=" + 
+                std::to_string(stride);
+        });
 
         VAO = std::make_unique<VertexArray>();
         VBO = std::make_unique<VertexBuffer>();
 
         VBO->SetData(data, dataSize);
+        vertexBytes = dataSize;
 
         VAO->Bind();
         VBO->Bind();
@@ -79,13 +97,86 @@ public:
         VAO->Unbind();
     }
 
+    // Uploads pre-built buffers as they are, e.g. straight from a memory-mapped
+    // cooked mesh. indexType is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+    GPUMesh(const void* vertexData, size_t numVertices, const VertexLayout& layout,
+            const void* indexData, size_t numIndices, GLenum type, const AABB& meshBounds)
+    {
+        usedIndices = numIndices > 0;
+        indexCount = numIndices;
+        vertexCount = numVertices;
+        indexType = type;
+        bounds = meshBounds;
+
+        VAO = std::make_unique<VertexArray>();
+        VBO = std::make_unique<VertexBuffer>();
+
+        VAO->Bind();
+
+        VBO->Bind();
+        VBO->SetData(vertexData, numVertices * layout.stride, GL_STATIC_DRAW);
+        vertexBytes = numVertices * layout.stride;
+
+        if (usedIndices)
+        {
+            EBO = std::make_unique<IndexBuffer>();
+            EBO->Bind();
+            EBO->SetData(indexData, static_cast<unsigned int>(numIndices), type, GL_STATIC_DRAW);
+            vertexBytes += numIndices * EBO->GetIndexSize();
+        }
+
+        VAO->SetLayout(layout);
+
+        VAO->Unbind();
+    }
+
     void Draw()
     {
         VAO->Bind();
         if (usedIndices)
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, 0);
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), indexType, 0);
         else
             glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertexCount));
         VAO->Unbind(); 
+
+        Profiler::Count(ProfileCounter::DRAW_CALLS);
+        Profiler::Count(ProfileCounter::TRIANGLES, (usedIndices ? indexCount : vertexCount) / 3);
+    }
+
+    void Bind() const { VAO->Bind(); }
+    void Unbind() const { VAO->Unbind(); }
+
+    // Points the per-instance attributes at a range of the shared instance buffer.
+    // The mesh must already be bound.
+    void SetInstanceLayout(const VertexBuffer& instances, size_t offset)
+    {
+        instances.Bind();
+
+        for (unsigned int i = 0; i < 4; i++)                                               // Model (one vec4 per column)
+            VAO->AddInstanceAttribute(5 + i, 4, GL_FLOAT, false, sizeof(InstanceData),
+                offset + offsetof(InstanceData, Model) + i * sizeof(glm::vec4));
+        VAO->AddInstanceAttribute(9, 3, GL_FLOAT, false, sizeof(InstanceData),
+            offset + offsetof(InstanceData, Color));                                        // Color
+    }
+
+    // Issues one instanced draw without touching VAO bindings.
+    void DrawInstanced(size_t instanceCount) const
+    {
+        if (usedIndices)
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indexCount), indexType, 0,
+                static_cast<GLsizei>(instanceCount));
+        else
+            glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(vertexCount),
+                static_cast<GLsizei>(instanceCount));
+
+        Profiler::Count(ProfileCounter::DRAW_CALLS);
+        Profiler::Count(ProfileCounter::TRIANGLES, (usedIndices ? indexCount : vertexCount) / 3 * instanceCount);
     }
+
+    unsigned int GetID() const { return VAO->GetID(); }
+    size_t GetIndexCount() const { return indexCount; }
+    size_t GetVertexCount() const { return vertexCount; }
+    bool UsesIndices() const { return usedIndices; }
+    const AABB& GetBounds() const { return bounds; }
+    size_t GetMemorySize() const { return vertexBytes; }
 };
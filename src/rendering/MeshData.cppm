@@ -1,7 +1,12 @@
 module;
 
+#include <glad/glad.h>
 #include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 export module XEngine.Rendering.MeshData;
 
@@ -15,6 +20,66 @@ export struct Vertex
     glm::vec3 Bitangent;
 };
 
+// Cooked meshes: 24 bytes instead of 56. Normal and tangent are signed
+// 10:10:10:2 (tangent w holds the bitangent sign, the bitangent itself is
+// rebuilt in the shader), UVs are half floats.
+export struct CompactVertex
+{
+    glm::vec3 Position;
+    uint32_t  Normal;       // GL_INT_2_10_10_10_REV
+    uint32_t  Tangent;      // GL_INT_2_10_10_10_REV, w = handedness
+    uint16_t  TexCoords[2]; // GL_HALF_FLOAT
+};
+
+static_assert(sizeof(Vertex) == 56, "Vertex layout changed");
+static_assert(sizeof(CompactVertex) == 24, "CompactVertex must stay tightly packed");
+
+export struct VertexAttribute
+{
+    unsigned int index;
+    int          components;
+    GLenum       type;
+    bool         normalized;
+    bool         integer;   // read as ivec/uvec through glVertexAttribIPointer
+    size_t       offset;
+};
+
+export struct VertexLayout
+{
+    std::vector<VertexAttribute> attributes;
+    int stride = 0;
+
+    static VertexLayout Standard()
+    {
+        return { {
+            { 0, 3, GL_FLOAT, false, false, offsetof(Vertex, Position) },
+            { 1, 3, GL_FLOAT, false, false, offsetof(Vertex, Normal) },
+            { 2, 2, GL_FLOAT, false, false, offsetof(Vertex, TexCoords) },
+            { 3, 3, GL_FLOAT, false, false, offsetof(Vertex, Tangent) },
+            { 4, 3, GL_FLOAT, false, false, offsetof(Vertex, Bitangent) },
+        }, sizeof(Vertex) };
+    }
+
+    static VertexLayout Compact()
+    {
+        return { {
+            { 0, 3, GL_FLOAT,              false, false, offsetof(CompactVertex, Position) },
+            { 1, 4, GL_INT_2_10_10_10_REV, true,  false, offsetof(CompactVertex, Normal) },
+            { 2, 2, GL_HALF_FLOAT,         false, false, offsetof(CompactVertex, TexCoords) },
+            { 3, 4, GL_INT_2_10_10_10_REV, true,  false, offsetof(CompactVertex, Tangent) },
+        }, sizeof(CompactVertex) };
+    }
+};
+
+// Per-instance data streamed to the GPU by the render queue.
+// Attribute locations: Model -> 5..8, Color -> 9.
+export struct InstanceData
+{
+    glm::mat4 Model;
+    glm::vec3 Color;
+    float     Padding;
+};
+
 export struct Texture
 {
     unsigned int id;
@@ -0,0 +1,180 @@
+module;
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+export module XEngine.Rendering.RenderQueue;
+
+import XEngine.Rendering.Buffer;
+import XEngine.Rendering.GPUMesh;
+import XEngine.Rendering.Material;
+import XEngine.Rendering.MeshData;
+
+import XEngine.Resource.Shader.ShaderManager;
+
+export struct RenderStats
+{
+    size_t submitted = 0;       // packets gathered (one per visible entity)
+    size_t drawCalls = 0;
+    size_t instances = 0;
+    size_t triangles = 0;
+
+    size_t shaderBinds = 0;
+    size_t materialBinds = 0;
+    size_t meshBinds = 0;
+
+    size_t instanceBytes = 0;
+
+    size_t GetStateChanges() const { return shaderBinds + materialBinds + meshBinds; }
+};
+
+export struct CullingStats
+{
+    size_t visible = 0;         // entities that passed the frustum query
+    size_t culled = 0;
+
+    size_t lightsVisible = 0;   // local lights whose range touches the frustum
+    size_t lightsCulled = 0;
+    size_t lightsSelected = 0;  // uploaded this frame, at most MAX_LIGHTS
+
+    size_t proxies = 0;
+    size_t reinserted = 0;      // proxies that left their fat bounds this frame
+    int treeHeight = 0;
+
+    double updateMs = 0.0;
+    double frustumQueryMs = 0.0;
+    double lightQueryMs = 0.0;
+    double pickQueryMs = 0.0;   // last viewport pick
+};
+
+export struct DrawPacket
+{
+    uint64_t key;
+    GPUMesh* mesh;
+    Material* material;
+    InstanceData instance;
+};
+
+// Collects draw packets for a frame, sorts them by (shader, material, mesh) and
+// submits every run that shares a mesh and material as one instanced draw.
+export class RenderQueue
+{
+private:
+    std::vector<DrawPacket> packets;
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    std::vector<InstanceData> instances;
+
+    InstanceBuffer instanceBuffer;
+    RenderStats stats;
+
+public:
+    // [63..56] shader | [55..32] material | [31..0] mesh
+    static uint64_t MakeKey(ShaderHandle shader, uint32_t material, uint32_t mesh)
+    {
+        return (static_cast<uint64_t>(shader.index & 0xFF) << 56) |
+               (static_cast<uint64_t>(material & 0xFFFFFF) << 32) |
+                static_cast<uint64_t>(mesh);
+    }
+
+    void Begin()
+    {
+        packets.clear();
+        stats = {};
+    }
+
+    void Submit(ShaderHandle shader, GPUMesh* mesh, Material* material, const glm::mat4& model, const glm::vec3& color)
+    {
+        if (!mesh || !material)
+            return;
+
+        packets.push_back({
+            MakeKey(shader, material->GetID(), mesh->GetID()),
+            mesh,
+            material,
+            { model, color, 0.0f }
+        });
+    }
+
+    void Flush(ShaderManager& shaderManager, ShaderHandle shader)
+    {
+        stats.submitted = packets.size();
+        if (packets.empty())
+            return;
+
+        order.clear();
+        order.reserve(packets.size());
+        for (uint32_t i = 0; i < packets.size(); i++)
+            order.emplace_back(packets[i].key, i);
+
+        std::sort(order.begin(), order.end());
+
+        // Instance data is laid out in sorted order so each batch is one contiguous range
+        instances.clear();
+        instances.reserve(order.size());
+        for (const auto& [key, index] : order)
+            instances.push_back(packets[index].instance);
+
+        stats.instanceBytes = instances.size() * sizeof(InstanceData);
+        instanceBuffer.Upload(instances.data(), stats.instanceBytes);
+
+        shaderManager.Bind(shader);
+        stats.shaderBinds++;
+
+        Material* boundMaterial = nullptr;
+        GPUMesh* boundMesh = nullptr;
+
+        size_t begin = 0;
+        while (begin < order.size())
+        {
+            const DrawPacket& first = packets[order[begin].second];
+
+            // Key collisions only cost a split batch: runs are checked by identity
+            size_t end = begin + 1;
+            while (end < order.size())
+            {
+                const DrawPacket& next = packets[order[end].second];
+                if (next.mesh != first.mesh || next.material != first.material)
+                    break;
+                end++;
+            }
+
+            if (first.material != boundMaterial)
+            {
+                first.material->Bind(shaderManager, shader);
+                boundMaterial = first.material;
+                stats.materialBinds++;
+            }
+
+            if (first.mesh != boundMesh)
+            {
+                first.mesh->Bind();
+                boundMesh = first.mesh;
+                stats.meshBinds++;
+            }
+
+            size_t count = end - begin;
+            first.mesh->SetInstanceLayout(instanceBuffer.GetBuffer(), begin * sizeof(InstanceData));
+            first.mesh->DrawInstanced(count);
+
+            size_t primitives = first.mesh->UsesIndices() ? first.mesh->GetIndexCount() : first.mesh->GetVertexCount();
+            stats.drawCalls++;
+            stats.instances += count;
+            stats.triangles += primitives / 3 * count;
+
+            begin = end;
+        }
+
+        if (boundMesh)
+            boundMesh->Unbind();
+        if (boundMaterial)
+            boundMaterial->Unbind();
+    }
+
+    const RenderStats& GetStats() const { return stats; }
+};
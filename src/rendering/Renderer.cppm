@@ -9,6 +9,7 @@ export module XEngine.Rendering.Renderer;
 
 import XEngine.Core.Camera;
 import XEngine.Rendering.Primitive.PrimitivesFactory;
+import XEngine.Rendering.RenderQueue;
 
 export struct RenderSettings 
 {
@@ -23,6 +24,8 @@ export class Renderer
 {
 private:
     RenderSettings settings;
+    RenderStats frameStats;
+    CullingStats cullingStats;
     std::unique_ptr<PrimitivesFactory> primitives;
 
     void ApplySettings()
@@ -82,6 +85,10 @@ public:
     // }
 
     RenderSettings& GetSettings() { return settings; }
+    const RenderStats& GetFrameStats() const { return frameStats; }
+    void SetFrameStats(const RenderStats& stats) { frameStats = stats; }
+    const CullingStats& GetCullingStats() const { return cullingStats; }
+    void SetCullingStats(const CullingStats& stats) { cullingStats = stats; }
     PrimitivesFactory* GetPrimitives() { return primitives.get(); }
 
     void EnableWireframe(bool enable) { settings.enableWireframe = enable; ApplySettings(); }
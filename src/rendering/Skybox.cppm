@@ -9,12 +9,12 @@ module;
 
 export module XEngine.Rendering.Skybox;
 
-import XEngine.Core.Camera;
-
 import XEngine.Rendering.Buffer; 
 
 import XEngine.Resource.Shader.ShaderManager;
 
+import XEngine.Core.Profiler;
+
 export class Skybox 
 {
 private:
@@ -91,21 +91,22 @@ public:
 
     //~Skybox() = default;
 
-    void Render(ShaderManager& shaderManager, const Camera& camera, const glm::mat4& projection)
+    // Camera matrices come from the shared Camera uniform block
+    void Render(ShaderManager& shaderManager)
     {
         glDepthFunc(GL_LEQUAL);
         shaderManager.Bind(shaderName);
 
-        glm::mat4 view = glm::mat4(glm::mat3(camera.GetViewMatrix()));
-        shaderManager.SetMat4(shaderName, "view", view);
-        shaderManager.SetMat4(shaderName, "projection", projection);
-
         skyboxVAO->Bind();
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
         glDrawArrays(GL_TRIANGLES, 0, 36);
         skyboxVAO->Unbind();
 
+        Profiler::Count(ProfileCounter::TEXTURE_BINDS);
+        Profiler::Count(ProfileCounter::DRAW_CALLS);
+        Profiler::Count(ProfileCounter::TRIANGLES, 12);
+
         glDepthFunc(GL_LESS);
     }
 
@@ -0,0 +1,58 @@
+module;
+
+#include <glm/glm.hpp>
+
+export module XEngine.Rendering.UniformBlocks;
+
+// CPU mirrors of the std140 uniform blocks shared by every shader program.
+// Keep in sync with the block declarations in assets/shaders.
+
+export constexpr unsigned int CAMERA_BLOCK_BINDING = 0;
+export constexpr unsigned int LIGHTS_BLOCK_BINDING = 1;
+
+export constexpr const char* CAMERA_BLOCK_NAME = "Camera";
+export constexpr const char* LIGHTS_BLOCK_NAME = "Lights";
+
+export constexpr int MAX_LIGHTS = 8;
+
+// layout (std140) uniform Camera
+export struct CameraBlock
+{
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec4 viewPos;      // xyz
+};
+
+// struct Light inside the Lights block, 96 bytes under std140
+export struct GPULight
+{
+    int   type;
+    float constant;
+    float linear;
+    float quadratic;
+
+    glm::vec3 position;
+    float     innerCutoff;  // cosine
+
+    glm::vec3 direction;
+    float     outerCutoff;  // cosine
+
+    glm::vec3 ambient;
+    float     padding0;
+    glm::vec3 diffuse;
+    float     padding1;
+    glm::vec3 specular;
+    float     padding2;
+};
+
+// layout (std140) uniform Lights
+export struct LightsBlock
+{
+    GPULight lights[MAX_LIGHTS];
+    int      numLights;
+    int      padding[3];
+};
+
+static_assert(sizeof(CameraBlock) == 144, "CameraBlock does not match std140 layout");
+static_assert(sizeof(GPULight) == 96, "GPULight does not match std140 layout");
+static_assert(sizeof(LightsBlock) == 96 * MAX_LIGHTS + 16, "LightsBlock does not match std140 layout");
@@ -29,6 +29,23 @@ enum class PrimitiveType
 export
 class PrimitivesFactory
 {
+private:
+    // Primitives of one type share a single GPUMesh so the render queue can
+    // batch them into instanced draws. The cache does not keep meshes alive.
+    static std::shared_ptr<GPUMesh> GetSharedGPUMesh(PrimitiveType type, const float* data, size_t dataSize)
+    {
+        static std::weak_ptr<GPUMesh> cache[3];
+
+        auto& slot = cache[static_cast<size_t>(type)];
+        std::shared_ptr<GPUMesh> gpuMesh = slot.lock();
+        if (!gpuMesh)
+        {
+            gpuMesh = std::make_shared<GPUMesh>(data, dataSize, 8);
+            slot = gpuMesh;
+        }
+        return gpuMesh;
+    }
+
 public:
     static Mesh* CreatePrimitive(PrimitiveType type)
     {
@@ -39,33 +56,30 @@ public:
                 size_t dataSize;
                 const float* data = PrimitiveGenerator::GetCubeData(dataSize);
 
-                auto gpuMesh = std::make_unique<GPUMesh>(data, dataSize, 8);
-                auto material = std::make_unique<Material>(glm::vec3(1.0f, 0.0f, 1.0f));
+                auto gpuMesh = GetSharedGPUMesh(type, data, dataSize);
+                auto material = std::make_shared<Material>(glm::vec3(1.0f, 0.0f, 1.0f));
 
-                auto mesh = std::make_unique<Mesh>(gpuMesh.release(), material.release());
-                return mesh.release();
+                return new Mesh(gpuMesh, material);
             }
             case PrimitiveType::QUAD:
             {
                 size_t dataSize;
                 const float* data = PrimitiveGenerator::GetQuadData(dataSize);
 
-                auto gpuMesh = std::make_unique<GPUMesh>(data, dataSize, 8);
-                auto material = std::make_unique<Material>(glm::vec3(1.0f, 1.0f, 1.0f));
+                auto gpuMesh = GetSharedGPUMesh(type, data, dataSize);
+                auto material = std::make_shared<Material>(glm::vec3(1.0f, 1.0f, 1.0f));
 
-                auto mesh = std::make_unique<Mesh>(gpuMesh.release(), material.release());
-                return mesh.release();
+                return new Mesh(gpuMesh, material);
             }
             case PrimitiveType::PLANE:
             {
                 size_t dataSize;
                 const float* data = PrimitiveGenerator::GetPlaneData(dataSize);
 
-                auto gpuMesh = std::make_unique<GPUMesh>(data, dataSize, 8);
-                auto material = std::make_unique<Material>(glm::vec3(1.0f, 1.0f, 1.0f));
+                auto gpuMesh = GetSharedGPUMesh(type, data, dataSize);
+                auto material = std::make_shared<Material>(glm::vec3(1.0f, 1.0f, 1.0f));
 
-                auto mesh = std::make_unique<Mesh>(gpuMesh.release(), material.release());
-                return mesh.release();
+                return new Mesh(gpuMesh, material);
             }
             default:
                 return nullptr;
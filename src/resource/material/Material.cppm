@@ -2,6 +2,7 @@ module;
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -11,6 +12,7 @@ export module XEngine.Rendering.Material;
 import XEngine.Rendering.MeshData; 
 import XEngine.Resource.Shader.ShaderManager;
 import XEngine.Core.Logger;
+import XEngine.Core.Profiler;
 
 export class Material
 {
@@ -21,6 +23,52 @@ private:
     glm::vec3 color;
     bool useColor = false;
 
+    // Stable identity used by the render queue's sort keys
+    uint32_t id = NextID();
+
+    static uint32_t NextID()
+    {
+        static uint32_t counter = 1;
+        return counter++;
+    }
+
+    // Resolved on first bind and whenever the texture set changes
+    UniformHandle useColorUniform;
+    UniformHandle colorUniform;
+    std::vector<UniformHandle> samplerUniforms;
+    bool uniformsResolved = false;
+
+    void ResolveUniforms(ShaderManager& shaderManager)
+    {
+        useColorUniform = shaderManager.GetUniform("useColor");
+        colorUniform = shaderManager.GetUniform("material.color");
+
+        unsigned int diffuseNr = 1;
+        unsigned int specularNr = 1;
+        unsigned int normalNr = 1;
+        unsigned int heightNr = 1;
+
+        samplerUniforms.clear();
+        for (const auto& texture : textures)
+        {
+            std::string number;
+            const std::string& texType = texture.type;
+
+            if (texType == "texture_diffuse") 
+                number = std::to_string(diffuseNr++);
+            else if (texType == "texture_specular") 
+                number = std::to_string(specularNr++);
+            else if (texType == "texture_normal") 
+                number = std::to_string(normalNr++);
+            else if (texType == "texture_height") 
+                number = std::to_string(heightNr++);
+
+            samplerUniforms.push_back(shaderManager.GetUniform("material." + texType + number));
+        }
+
+        uniformsResolved = true;
+    }
+
 public:
     Material(const std::vector<Texture>& textures, const std::string& materialName = "unnamed")
         : name(materialName), type("texture"), textures(textures), useColor(false), color(1.0f, 1.0f, 1.0f) 
@@ -60,52 +108,43 @@ public:
         this->color = other.color;
         this->textures = other.textures;
         this->useColor = other.useColor;
+        this->uniformsResolved = false;
 
         return *this;
     }
 
-    void Bind(ShaderManager& shaderManager, const std::string& shaderName)
+    void Bind(ShaderManager& shaderManager, ShaderHandle shader)
     {
-        shaderManager.Bind(shaderName);
+        if (!uniformsResolved)
+            ResolveUniforms(shaderManager);
+
+        shaderManager.Bind(shader);
 
-        shaderManager.SetBool(shaderName, "useColor", useColor);
+        shaderManager.SetBool(shader, useColorUniform, useColor);
 
         if (useColor)
         {
-            shaderManager.SetVec3(shaderName, "material.color", color);
+            shaderManager.SetVec3(shader, colorUniform, color);
         }
         else
         {
-            unsigned int diffuseNr = 1;
-            unsigned int specularNr = 1;
-            unsigned int normalNr = 1;
-            unsigned int heightNr = 1;
-
             for (unsigned int i = 0; i < textures.size(); i++)
             {
                 glActiveTexture(GL_TEXTURE0 + i);
-
-                std::string number;
-                std::string texType = textures[i].type;
-
-                if (texType == "texture_diffuse") 
-                    number = std::to_string(diffuseNr++);
-                else if (texType == "texture_specular") 
-                    number = std::to_string(specularNr++);
-                else if (texType == "texture_normal") 
-                    number = std::to_string(normalNr++);
-                else if (texType == "texture_height") 
-                    number = std::to_string(heightNr++);
-
-                std::string uniformName = "material." + texType + number;
-                shaderManager.SetInt(shaderName, uniformName.c_str(), i);
+                shaderManager.SetInt(shader, samplerUniforms[i], i);
                 glBindTexture(GL_TEXTURE_2D, textures[i].id);
             }
+            Profiler::Count(ProfileCounter::TEXTURE_BINDS, textures.size());
 
             glActiveTexture(GL_TEXTURE0);
         }
     }
 
+    void Bind(ShaderManager& shaderManager, const std::string& shaderName)
+    {
+        Bind(shaderManager, shaderManager.GetHandle(shaderName));
+    }
+
     void Unbind()
     {
         if (!useColor)
@@ -124,12 +163,14 @@ public:
         color = newColor; 
         useColor = true;
         textures.clear();
+        uniformsResolved = false;
     }
 
     void SetTextures(std::vector<Texture> newTextures) 
     { 
         textures = newTextures; 
         useColor = false;
+        uniformsResolved = false;
     }
     
     void SetColorUsing(bool newUsing) { useColor = newUsing; }
@@ -142,4 +183,5 @@ public:
     bool IsUsingColor() const { return useColor; }
     const std::string& GetName() const { return name; }
     const std::string& GetType() const { return type; }
+    uint32_t GetID() const { return id; }
 };
\ No newline at end of file
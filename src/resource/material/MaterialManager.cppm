@@ -14,6 +14,7 @@ import XEngine.Rendering.MeshData;
 import XEngine.Rendering.Material;
 
 import XEngine.Resource.Texture.TextureManager;
+import XEngine.Resource.Texture.TextureCache;
 import XEngine.Resource.Material.MaterialConfigLoader;
 
 import XEngine.Core.Logger;
@@ -133,7 +134,7 @@ public:
 
         if (!normalPath.empty())
         {
-            unsigned int normalMap = textureManager->LoadTexture(normalPath);
+            unsigned int normalMap = textureManager->LoadTexture(normalPath, TextureUsage::NORMAL);
             if (normalMap != 0)
             {
                 Texture norm
@@ -148,7 +149,7 @@ public:
 
         if (!heightPath.empty())
         {
-            unsigned int heightMap = textureManager->LoadTexture(heightPath);
+            unsigned int heightMap = textureManager->LoadTexture(heightPath, TextureUsage::DATA);
             if (heightMap != 0)
             {
                 Texture height
@@ -0,0 +1,600 @@
+module;
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+module XEngine.Scene.Model;
+
+import XEngine.Core.Logger;
+import XEngine.Core.MappedFile;
+
+import XEngine.Rendering.Bounds;
+import XEngine.Rendering.MeshData;
+
+// ───── File format ─────
+//
+// FileHeader | MeshEntry[meshCount] | TextureEntry[...] | vertex/index blobs
+// Blobs are 16-byte aligned. Everything is little-endian, as written by the host.
+
+namespace
+{
+    constexpr char     COOKED_MAGIC[4] = { 'X', 'M', 'S', 'H' };
+    constexpr uint32_t COOKED_VERSION = 1;
+    constexpr size_t   BLOB_ALIGNMENT = 16;
+
+    // Cooks run on pool workers, so every writer needs its own temporary
+    std::atomic<uint32_t> tempCounter{0};
+
+    constexpr uint32_t MESH_COMPACT = 1u << 0;
+    constexpr uint32_t MESH_INDEX16 = 1u << 1;
+
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t meshCount;
+        uint32_t textureCount;
+        uint64_t sourceSize;
+        int64_t  sourceTime;
+    };
+
+    struct MeshEntry
+    {
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t vertexStride;
+        uint32_t flags;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        float    boundsMin[3];
+        float    boundsMax[3];
+        uint32_t firstTexture;
+        uint32_t textureCount;
+    };
+
+    struct TextureEntry
+    {
+        char type[32];
+        char path[224];     // relative to the model directory
+    };
+
+    static_assert(sizeof(FileHeader) == 32);
+    static_assert(sizeof(MeshEntry) == 64);
+    static_assert(sizeof(TextureEntry) == 256);
+
+    struct SourceStamp
+    {
+        uint64_t size = 0;
+        int64_t  time = 0;
+        bool     valid = false;
+    };
+
+    SourceStamp GetSourceStamp(const std::string& path)
+    {
+        std::error_code ec;
+        SourceStamp stamp;
+        stamp.size = std::filesystem::file_size(path, ec);
+        if (ec)
+            return stamp;
+
+        auto time = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return stamp;
+
+        stamp.time = static_cast<int64_t>(time.time_since_epoch().count());
+        stamp.valid = true;
+        return stamp;
+    }
+
+    size_t AlignUp(size_t value)
+    {
+        return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+    }
+
+    // ───── Vertex encoding ─────
+
+    uint32_t PackSnorm1010102(const glm::vec4& v)
+    {
+        auto pack = [](float value, float scale, uint32_t mask)
+        {
+            int32_t i = static_cast<int32_t>(std::round(glm::clamp(value, -1.0f, 1.0f) * scale));
+            return static_cast<uint32_t>(i) & mask;
+        };
+
+        return pack(v.x, 511.0f, 0x3FF)
+            | (pack(v.y, 511.0f, 0x3FF) << 10)
+            | (pack(v.z, 511.0f, 0x3FF) << 20)
+            | (pack(v.w, 1.0f, 0x3) << 30);
+    }
+
+    glm::vec3 SafeNormalize(const glm::vec3& v)
+    {
+        float length = glm::length(v);
+        return length > 1e-8f ? v / length : glm::vec3(0.0f);
+    }
+
+    CompactVertex EncodeVertex(const Vertex& vertex)
+    {
+        CompactVertex out;
+        out.Position = vertex.Position;
+
+        glm::vec3 normal = SafeNormalize(vertex.Normal);
+        glm::vec3 tangent = SafeNormalize(vertex.Tangent);
+        float handedness = glm::dot(glm::cross(normal, tangent), vertex.Bitangent) < 0.0f ? -1.0f : 1.0f;
+
+        out.Normal = PackSnorm1010102(glm::vec4(normal, 0.0f));
+        out.Tangent = PackSnorm1010102(glm::vec4(tangent, handedness));
+        out.TexCoords[0] = glm::packHalf1x16(vertex.TexCoords.x);
+        out.TexCoords[1] = glm::packHalf1x16(vertex.TexCoords.y);
+        return out;
+    }
+
+    // ───── Vertex cache optimization ─────
+    //
+    // Tom Forsyth's "Linear-Speed Vertex Cache Optimisation": greedily emit the
+    // triangle whose vertices score highest against a simulated LRU cache.
+
+    constexpr int   CACHE_SIZE = 32;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRI_SCORE = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    float VertexScore(int cachePosition, uint32_t remainingValence)
+    {
+        if (remainingValence == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+                score = LAST_TRI_SCORE;
+            else
+            {
+                float scaler = 1.0f / (CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingValence), -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0)
+            return indices;
+
+        // Triangle adjacency per vertex, packed
+        std::vector<uint32_t> valence(vertexCount, 0);
+        for (uint32_t index : indices)
+            valence[index]++;
+
+        std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; v++)
+            adjacencyStart[v + 1] = adjacencyStart[v] + valence[v];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (size_t t = 0; t < triCount; t++)
+            for (size_t k = 0; k < 3; k++)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+
+        std::vector<int>   cachePosition(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+            vertexScore[v] = VertexScore(-1, valence[v]);
+
+        std::vector<float> triScore(triCount);
+        std::vector<bool>  emitted(triCount, false);
+        for (size_t t = 0; t < triCount; t++)
+            triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> nextCache;
+        cache.reserve(CACHE_SIZE + 3);
+        nextCache.reserve(CACHE_SIZE + 3);
+
+        size_t scanCursor = 0;
+        int64_t best = -1;
+
+        for (size_t emittedCount = 0; emittedCount < triCount; emittedCount++)
+        {
+            if (best < 0)
+            {
+                // Nothing in the cache touches a live triangle; take the next one in order
+                while (emitted[scanCursor])
+                    scanCursor++;
+                best = static_cast<int64_t>(scanCursor);
+            }
+
+            const uint32_t* tri = &indices[static_cast<size_t>(best) * 3];
+            emitted[best] = true;
+
+            nextCache.clear();
+            for (size_t k = 0; k < 3; k++)
+            {
+                uint32_t v = tri[k];
+                output.push_back(v);
+                nextCache.push_back(v);
+
+                // Drop the triangle from the vertex's live list
+                uint32_t* begin = &adjacency[adjacencyStart[v]];
+                uint32_t* end = begin + valence[v];
+                uint32_t* it = std::find(begin, end, static_cast<uint32_t>(best));
+                std::swap(*it, *(end - 1));
+                valence[v]--;
+            }
+
+            for (uint32_t v : cache)
+                if (v != tri[0] && v != tri[1] && v != tri[2])
+                    nextCache.push_back(v);
+
+            for (size_t i = 0; i < nextCache.size(); i++)
+            {
+                uint32_t v = nextCache[i];
+                cachePosition[v] = i < CACHE_SIZE ? static_cast<int>(i) : -1;
+            }
+
+            // Rescore vertices whose cache position changed and their live triangles
+            best = -1;
+            float bestScore = -1.0f;
+            for (uint32_t v : nextCache)
+            {
+                float newScore = VertexScore(cachePosition[v], valence[v]);
+                float delta = newScore - vertexScore[v];
+                vertexScore[v] = newScore;
+
+                for (uint32_t a = 0; a < valence[v]; a++)
+                {
+                    uint32_t t = adjacency[adjacencyStart[v] + a];
+                    triScore[t] += delta;
+                    if (triScore[t] > bestScore)
+                    {
+                        bestScore = triScore[t];
+                        best = t;
+                    }
+                }
+            }
+
+            if (nextCache.size() > CACHE_SIZE)
+                nextCache.resize(CACHE_SIZE);
+            std::swap(cache, nextCache);
+        }
+
+        return output;
+    }
+
+    // ───── Cooking ─────
+
+    struct CookedMeshBlob
+    {
+        std::vector<CompactVertex> vertices;
+        std::vector<uint32_t> indices;
+        AABB bounds;
+    };
+
+    CookedMeshBlob CookMesh(const ModelMeshData& mesh)
+    {
+        CookedMeshBlob blob;
+
+        // Deduplicate on the encoded bytes, so vertices that only differed
+        // below the quantization step collapse too
+        std::unordered_map<std::string_view, uint32_t> unique;
+        std::vector<CompactVertex> encoded(mesh.vertices.size());
+        std::vector<uint32_t> remap(mesh.vertices.size());
+
+        std::vector<CompactVertex> merged;
+        merged.reserve(mesh.vertices.size());
+        unique.reserve(mesh.vertices.size());
+
+        for (size_t i = 0; i < mesh.vertices.size(); i++)
+        {
+            encoded[i] = EncodeVertex(mesh.vertices[i]);
+            std::string_view key(reinterpret_cast<const char*>(&encoded[i]), sizeof(CompactVertex));
+
+            auto [it, inserted] = unique.try_emplace(key, static_cast<uint32_t>(merged.size()));
+            if (inserted)
+                merged.push_back(encoded[i]);
+            remap[i] = it->second;
+        }
+
+        std::vector<uint32_t> indices;
+        indices.reserve(mesh.indices.size());
+        // Drop whole triangles, so one bad index cannot shift every later triangle
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            unsigned int a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+            if (a >= remap.size() || b >= remap.size() || c >= remap.size())
+                continue;
+
+            indices.push_back(remap[a]);
+            indices.push_back(remap[b]);
+            indices.push_back(remap[c]);
+        }
+
+        indices = OptimizeVertexCache(indices, merged.size());
+
+        // Lay vertices out in first-use order so fetches walk the buffer forward
+        std::vector<uint32_t> order(merged.size(), UINT32_MAX);
+        blob.vertices.reserve(merged.size());
+        for (uint32_t& index : indices)
+        {
+            if (order[index] == UINT32_MAX)
+            {
+                order[index] = static_cast<uint32_t>(blob.vertices.size());
+                blob.vertices.push_back(merged[index]);
+            }
+            index = order[index];
+        }
+
+        blob.indices = std::move(indices);
+        for (const CompactVertex& vertex : blob.vertices)
+            blob.bounds.Expand(vertex.Position);
+
+        return blob;
+    }
+
+    void CopyString(char* dst, size_t capacity, const std::string& src)
+    {
+        std::memset(dst, 0, capacity);
+        std::memcpy(dst, src.data(), std::min(src.size(), capacity - 1));
+    }
+
+    std::string ReadString(const char* src, size_t capacity)
+    {
+        return std::string(src, strnlen(src, capacity));
+    }
+}
+
+std::vector<std::string> Model::FindSourceFiles(const std::string& directory)
+{
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        std::string extension = entry.path().extension().string();
+        if (entry.is_regular_file() && (extension == ".obj" || extension == ".fbx" || extension == ".gltf" ||
+                                        extension == ".glb" || extension == ".dae"))
+            paths.push_back(entry.path().generic_string());
+    }
+
+    // Directory order is not stable across file systems
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::string Model::GetCookedPath(const std::string& sourcePath)
+{
+    return sourcePath + ".xmesh";
+}
+
+bool Model::WriteCooked(const ModelData& data, const std::string& sourcePath)
+{
+    SourceStamp stamp = GetSourceStamp(sourcePath);
+    if (!stamp.valid || !data.valid)
+        return false;
+
+    std::vector<MeshEntry> entries(data.meshes.size());
+    std::vector<TextureEntry> textures;
+    std::vector<CookedMeshBlob> blobs;
+    blobs.reserve(data.meshes.size());
+
+    const std::string prefix = data.directory + '/';
+
+    for (size_t m = 0; m < data.meshes.size(); m++)
+    {
+        const ModelMeshData& mesh = data.meshes[m];
+        MeshEntry& entry = entries[m];
+        std::memset(&entry, 0, sizeof(entry));
+
+        entry.firstTexture = static_cast<uint32_t>(textures.size());
+        entry.textureCount = static_cast<uint32_t>(mesh.textures.size());
+        for (const TextureRef& ref : mesh.textures)
+        {
+            std::string relative = ref.path.starts_with(prefix) ? ref.path.substr(prefix.size()) : ref.path;
+
+            TextureEntry texture;
+            CopyString(texture.type, sizeof(texture.type), ref.type);
+            CopyString(texture.path, sizeof(texture.path), relative);
+            textures.push_back(texture);
+        }
+
+        blobs.push_back(CookMesh(mesh));
+        const CookedMeshBlob& blob = blobs.back();
+
+        entry.vertexCount = static_cast<uint32_t>(blob.vertices.size());
+        entry.indexCount = static_cast<uint32_t>(blob.indices.size());
+        entry.vertexStride = sizeof(CompactVertex);
+        entry.flags = MESH_COMPACT | (blob.vertices.size() <= 0xFFFF ? MESH_INDEX16 : 0);
+
+        glm::vec3 boundsMin = blob.bounds.IsValid() ? blob.bounds.min : glm::vec3(0.0f);
+        glm::vec3 boundsMax = blob.bounds.IsValid() ? blob.bounds.max : glm::vec3(0.0f);
+        std::memcpy(entry.boundsMin, &boundsMin, sizeof(entry.boundsMin));
+        std::memcpy(entry.boundsMax, &boundsMax, sizeof(entry.boundsMax));
+    }
+
+    // Assign blob offsets after the tables
+    size_t offset = AlignUp(sizeof(FileHeader) + entries.size() * sizeof(MeshEntry) + textures.size() * sizeof(TextureEntry));
+    for (size_t m = 0; m < entries.size(); m++)
+    {
+        MeshEntry& entry = entries[m];
+        entry.vertexOffset = offset;
+        offset = AlignUp(offset + size_t(entry.vertexCount) * entry.vertexStride);
+
+        entry.indexOffset = offset;
+        size_t indexSize = (entry.flags & MESH_INDEX16) ? sizeof(uint16_t) : sizeof(uint32_t);
+        offset = AlignUp(offset + size_t(entry.indexCount) * indexSize);
+    }
+
+    std::vector<uint8_t> file(offset, 0);
+
+    FileHeader header;
+    std::memcpy(header.magic, COOKED_MAGIC, sizeof(header.magic));
+    header.version = COOKED_VERSION;
+    header.meshCount = static_cast<uint32_t>(entries.size());
+    header.textureCount = static_cast<uint32_t>(textures.size());
+    header.sourceSize = stamp.size;
+    header.sourceTime = stamp.time;
+
+    uint8_t* cursor = file.data();
+    std::memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+    if (!entries.empty())
+        std::memcpy(cursor, entries.data(), entries.size() * sizeof(MeshEntry));
+    cursor += entries.size() * sizeof(MeshEntry);
+    if (!textures.empty())
+        std::memcpy(cursor, textures.data(), textures.size() * sizeof(TextureEntry));
+
+    for (size_t m = 0; m < entries.size(); m++)
+    {
+        const MeshEntry& entry = entries[m];
+        const CookedMeshBlob& blob = blobs[m];
+
+        if (!blob.vertices.empty())
+            std::memcpy(file.data() + entry.vertexOffset, blob.vertices.data(), blob.vertices.size() * sizeof(CompactVertex));
+
+        if (entry.flags & MESH_INDEX16)
+        {
+            uint16_t* out = reinterpret_cast<uint16_t*>(file.data() + entry.indexOffset);
+            for (size_t i = 0; i < blob.indices.size(); i++)
+                out[i] = static_cast<uint16_t>(blob.indices[i]);
+        }
+        else if (!blob.indices.empty())
+        {
+            std::memcpy(file.data() + entry.indexOffset, blob.indices.data(), blob.indices.size() * sizeof(uint32_t));
+        }
+    }
+
+    // Write to a temporary and rename, so a concurrent reader never maps a half-written file
+    const std::string cookedPath = GetCookedPath(sourcePath);
+    const std::string tempPath = cookedPath + "." + std::to_string(tempCounter.fetch_add(1)) + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            Logger::Log(LogLevel::WARNING, "Cannot write cooked mesh: " + cookedPath);
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            Logger::Log(LogLevel::WARNING, "Cannot write cooked mesh: " + cookedPath);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cookedPath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    Logger::Log(LogLevel::INFO, "Cooked mesh: " + cookedPath + " (" + std::to_string(file.size() / 1024) + " KB)");
+    return true;
+}
+
+ModelData Model::LoadCooked(const std::string& sourcePath)
+{
+    ModelData data;
+    data.path = sourcePath;
+
+    const std::string cookedPath = GetCookedPath(sourcePath);
+    if (!std::filesystem::exists(cookedPath))
+        return data;
+
+    auto mapping = std::make_shared<MappedFile>(cookedPath);
+    if (!mapping->IsValid() || mapping->GetSize() < sizeof(FileHeader))
+        return data;
+
+    const uint8_t* base = mapping->GetData();
+    const size_t size = mapping->GetSize();
+
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, COOKED_MAGIC, sizeof(header.magic)) != 0 || header.version != COOKED_VERSION)
+        return data;
+
+    // A missing source is fine: ship the cooked file on its own
+    SourceStamp stamp = GetSourceStamp(sourcePath);
+    if (stamp.valid && (stamp.size != header.sourceSize || stamp.time != header.sourceTime))
+    {
+        Logger::Log(LogLevel::DEBUG, "Cooked mesh is stale: " + cookedPath);
+        return data;
+    }
+
+    const size_t tablesSize = sizeof(FileHeader) + size_t(header.meshCount) * sizeof(MeshEntry)
+        + size_t(header.textureCount) * sizeof(TextureEntry);
+    if (tablesSize > size)
+        return data;
+
+    const MeshEntry* entries = reinterpret_cast<const MeshEntry*>(base + sizeof(FileHeader));
+    const TextureEntry* textures = reinterpret_cast<const TextureEntry*>(entries + header.meshCount);
+
+    data.directory = sourcePath.substr(0, sourcePath.find_last_of('/'));
+    data.meshes.resize(header.meshCount);
+
+    for (uint32_t m = 0; m < header.meshCount; m++)
+    {
+        const MeshEntry& entry = entries[m];
+        ModelMeshData& mesh = data.meshes[m];
+
+        const bool compact = entry.flags & MESH_COMPACT;
+        const bool index16 = entry.flags & MESH_INDEX16;
+        mesh.cookedLayout = compact ? VertexLayout::Compact() : VertexLayout::Standard();
+
+        const size_t vertexBytes = size_t(entry.vertexCount) * entry.vertexStride;
+        const size_t indexBytes = size_t(entry.indexCount) * (index16 ? sizeof(uint16_t) : sizeof(uint32_t));
+
+        if (entry.vertexStride != static_cast<uint32_t>(mesh.cookedLayout.stride)
+            || entry.vertexOffset + vertexBytes > size || entry.indexOffset + indexBytes > size
+            || size_t(entry.firstTexture) + entry.textureCount > header.textureCount)
+        {
+            Logger::Log(LogLevel::ERROR, "Corrupt cooked mesh: " + cookedPath);
+            return ModelData{ sourcePath };
+        }
+
+        mesh.cookedVertices = base + entry.vertexOffset;
+        mesh.cookedIndices = base + entry.indexOffset;
+        mesh.cookedVertexCount = entry.vertexCount;
+        mesh.cookedIndexCount = entry.indexCount;
+        mesh.cookedIndexType = index16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        mesh.cookedBounds = AABB{ glm::vec3(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2]),
+                                  glm::vec3(entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]) };
+
+        for (uint32_t t = 0; t < entry.textureCount; t++)
+        {
+            const TextureEntry& texture = textures[entry.firstTexture + t];
+            mesh.textures.push_back({ ReadString(texture.type, sizeof(texture.type)),
+                                      data.directory + '/' + ReadString(texture.path, sizeof(texture.path)) });
+        }
+    }
+
+    data.mapping = std::move(mapping);
+    data.valid = true;
+    return data;
+}
@@ -5,12 +5,10 @@ module;
 #include <assimp/postprocess.h>
 #include <assimp/mesh.h>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
-#include <stb_image.h>
 
 #include <vector>
-//#include <memory>
+#include <memory>
 #include <string>
 //#include <utility>
 
@@ -19,9 +17,12 @@ module XEngine.Scene.Model;
 import XEngine.Scene.Mesh;
 
 import XEngine.Rendering.MeshData;
+import XEngine.Rendering.GPUMesh;
+import XEngine.Rendering.Material;
 import XEngine.Core.Logger; 
 
 import XEngine.Resource.Shader.ShaderManager;
+import XEngine.Resource.Texture.TextureManager;
 
 void Model::Draw(ShaderManager& shaderManager, const std::string& name) 
 {
@@ -41,39 +42,90 @@ void Model::SetTextures(const std::vector<Texture>& textures)
         mesh.SetTextures(textures);
 }
 
-void Model::loadModel(const std::string& path) {
+ModelData Model::Import(const std::string& path, bool useCache) {
+    if (!useCache)
+        return importSource(path);
+
+    ModelData cooked = LoadCooked(path);
+    if (cooked.valid)
+        return cooked;
+
+    ModelData data = importSource(path);
+    if (!data.valid)
+        return data;
+
+    // Fall back to the Assimp data if the cache cannot be written
+    if (WriteCooked(data, path)) {
+        cooked = LoadCooked(path);
+        if (cooked.valid)
+            return cooked;
+    }
+
+    return data;
+}
+
+ModelData Model::importSource(const std::string& path) {
+    ModelData data;
+    data.path = path;
+
     Assimp::Importer import;
     const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate);
     
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        return;
+        Logger::Log(LogLevel::ERROR, "Failed to import model: " + path);
+        return data;
     }
     
-    directory = path.substr(0, path.find_last_of('/'));
-    processNode(scene->mRootNode, scene);
+    data.directory = path.substr(0, path.find_last_of('/'));
+    processNode(scene->mRootNode, scene, data);
+    data.valid = true;
+    return data;
 }
 
-void Model::processNode(aiNode* nodePtr, const aiScene* scenePtr) {
-    aiNode* node = static_cast<aiNode*>(nodePtr);
-    const aiScene* scene = static_cast<const aiScene*>(scenePtr);
-    
+void Model::Build(ModelData&& data, TextureManager& textureManager) {
+    directory = data.directory;
+
+    for (auto& meshData : data.meshes) {
+        std::vector<Texture> textures;
+        for (const auto& ref : meshData.textures) {
+            Texture texture;
+            texture.id = textureManager.LoadTexture(ref.path);
+            texture.type = ref.type;
+            texture.path = ref.path;
+            textures.push_back(texture);
+        }
+
+        if (meshData.IsCooked()) {
+            auto gpuMesh = std::make_shared<GPUMesh>(meshData.cookedVertices, meshData.cookedVertexCount, meshData.cookedLayout,
+                                                     meshData.cookedIndices, meshData.cookedIndexCount, meshData.cookedIndexType,
+                                                     meshData.cookedBounds);
+            meshes.emplace_back(std::move(gpuMesh), std::make_shared<Material>(textures));
+            continue;
+        }
+
+        meshes.emplace_back(std::move(meshData.vertices), std::move(meshData.indices), std::move(textures));
+    }
+
+    // GL has its own copy now; drop the mapping
+    data.mapping.reset();
+    ready = true;
+}
+
+void Model::processNode(aiNode* node, const aiScene* scene, ModelData& data) {
     for (unsigned int i = 0; i < node->mNumMeshes; i++) {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes.push_back(processMesh(mesh, scene));
+        data.meshes.push_back(processMesh(mesh, scene, data.directory));
     }
 
     for (unsigned int i = 0; i < node->mNumChildren; i++) {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], scene, data);
     }
 }
 
-Mesh Model::processMesh(aiMesh* meshPtr, const aiScene* scenePtr) {
-    aiMesh* mesh = static_cast<aiMesh*>(meshPtr);
-    const aiScene* scene = static_cast<const aiScene*>(scenePtr);
-    
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+ModelMeshData Model::processMesh(aiMesh* mesh, const aiScene* scene, const std::string& directory) {
+    ModelMeshData data;
+    std::vector<Vertex>& vertices = data.vertices;
+    std::vector<unsigned int>& indices = data.indices;
 
     // Обробка вершин
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
@@ -135,82 +187,21 @@ Mesh Model::processMesh(aiMesh* meshPtr, const aiScene* scenePtr) {
     if (mesh->mMaterialIndex >= 0) {
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
         
-        std::vector<Texture> diffuseMaps = loadMaterialTextures(
-            material, aiTextureType_DIFFUSE, "texture_diffuse"
-        );
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-        
-        std::vector<Texture> specularMaps = loadMaterialTextures(
-            material, aiTextureType_SPECULAR, "texture_specular"
-        );
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", directory, data.textures);
+        loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", directory, data.textures);
     }
     
-    return Mesh(vertices, indices, textures);
+    return data;
 }
 
-std::vector<Texture> Model::loadMaterialTextures(void* matPtr, int type, const std::string& typeName) {
-    aiMaterial* mat = static_cast<aiMaterial*>(matPtr);
-    aiTextureType texType = static_cast<aiTextureType>(type);
-    
-    std::vector<Texture> textures;
-    unsigned int textureCount = mat->GetTextureCount(texType);
+void Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName,
+                                 const std::string& directory, std::vector<TextureRef>& textures) {
+    unsigned int textureCount = mat->GetTextureCount(type);
 
+    // Duplicates across meshes are shared by TextureManager
     for (unsigned int i = 0; i < textureCount; i++) {
         aiString str;
-        mat->GetTexture(texType, i, &str);
-        bool skip = false;
-        
-        for (const auto& loadedTex : textures_loaded) {
-            if (loadedTex.path == str.C_Str()) {
-                textures.push_back(loadedTex);
-                skip = true;
-                break;
-            }
-        }
-        
-        if (!skip) {   
-            Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), directory);
-            texture.type = typeName;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            textures_loaded.push_back(texture);
-        }
+        mat->GetTexture(type, i, &str);
+        textures.push_back({ typeName, directory + '/' + std::string(str.C_Str()) });
     }
-
-    return textures;
 }
-
-unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma) {
-    std::string filename = directory + '/' + std::string(path);
- 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
- 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    
-    if (data) {
-        GLenum format = GL_RGB;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
- 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
- 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
- 
-        stbi_image_free(data);
-    }
- 
-    return textureID;
-}
\ No newline at end of file
@@ -3,6 +3,7 @@ module;
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstddef>
 
 #include <glm/glm.hpp>
 
@@ -12,36 +13,96 @@ module;
 
 export module XEngine.Scene.Model;
 
+import XEngine.Core.MappedFile;
+
 import XEngine.Scene.Mesh;
 
+import XEngine.Rendering.Bounds;
 import XEngine.Rendering.MeshData;
 import XEngine.Rendering.Material;
 
 import XEngine.Resource.Shader.ShaderManager;
+import XEngine.Resource.Texture.TextureManager;
+
+export struct TextureRef
+{
+    std::string type;
+    std::string path;   // resolved against the model's directory
+};
+
+export struct ModelMeshData
+{
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<TextureRef> textures;
+
+    // Cooked meshes point into ModelData::mapping instead of filling the vectors
+    const void*  cookedVertices = nullptr;
+    const void*  cookedIndices = nullptr;
+    size_t       cookedVertexCount = 0;
+    size_t       cookedIndexCount = 0;
+    VertexLayout cookedLayout;
+    unsigned int cookedIndexType = 0;
+    AABB         cookedBounds;
+
+    bool IsCooked() const { return cookedVertices != nullptr; }
+};
+
+// CPU side of a model: everything Assimp produces, with no GL objects, so it
+// can be built on a worker thread
+export struct ModelData
+{
+    std::string path;
+    std::string directory;
+    std::vector<ModelMeshData> meshes;
+    std::shared_ptr<MappedFile> mapping;    // keeps cooked mesh data alive until Build
+    bool valid = false;
+};
 
 export class Model 
 {
 private:
     std::vector<Mesh> meshes;
-    std::vector<Texture> textures_loaded;
     std::string directory;
+    bool ready = false;
+
+    static void processNode(aiNode* node, const aiScene* scene, ModelData& data);
+    static ModelMeshData processMesh(aiMesh* mesh, const aiScene* scene, const std::string& directory);
+    static void loadMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName, 
+                                     const std::string& directory, std::vector<TextureRef>& textures);
 
-    void loadModel(const std::string& path);
-    void processNode(aiNode* node, const aiScene* scene);
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-    std::vector<Texture> loadMaterialTextures(void* mat, int type, const std::string& typeName);
+    static ModelData importSource(const std::string& path);
 
 public:
-    Model(const char* path) 
+    // Empty until Build is called; used as the handle for asynchronous loads
+    Model() = default;
+
+    Model(const char* path, TextureManager& textureManager) 
     {
-        loadModel(path);
+        Build(Import(path), textureManager);
     }
 
     Model(Mesh* mesh, std::string name = "") 
     { 
         meshes.push_back(std::move(*mesh)); 
+        ready = true;
     }
 
+    // Loads the cooked file next to the source when it is up to date, otherwise
+    // runs Assimp and cooks it. Touches no GL state, safe on any thread.
+    static ModelData Import(const std::string& path, bool useCache = true);
+
+    // Cooked mesh cache (MeshCooker.cpp)
+    static std::vector<std::string> FindSourceFiles(const std::string& directory);    // recursive, sorted
+    static std::string GetCookedPath(const std::string& sourcePath);
+    static bool WriteCooked(const ModelData& data, const std::string& sourcePath);
+    static ModelData LoadCooked(const std::string& sourcePath);
+
+    // Creates GPU meshes and requests textures. Render thread only.
+    void Build(ModelData&& data, TextureManager& textureManager);
+
+    bool IsReady() const { return ready; }
+
     void Draw(ShaderManager& shaderManager, const std::string& name);
 
     void SetColor(const glm::vec3& color);
@@ -64,6 +125,4 @@ public:
             return &meshes[index];
         return nullptr;
     }
-};
-
-unsigned int TextureFromFile(const char *path, const std::string &directory, bool gamma = false);
\ No newline at end of file
+};
\ No newline at end of file
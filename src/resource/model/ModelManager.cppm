@@ -0,0 +1,183 @@
+module;
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+export module XEngine.Resource.Model.ModelManager;
+
+import XEngine.Core.Logger;
+import XEngine.Core.ThreadPool;
+
+import XEngine.Scene.Model;
+
+import XEngine.Resource.Texture.TextureManager;
+
+export struct ModelLoadStats
+{
+    size_t requested = 0;
+    size_t deduplicated = 0;
+    size_t built = 0;
+    size_t failed = 0;
+
+    double importMs = 0.0;      // summed over workers
+    double buildMs = 0.0;       // render thread
+};
+
+// Assimp import runs on the thread pool; GPU meshes are built on the render
+// thread in ProcessUploads. LoadModel hands back an empty Model right away that
+// fills in once built. Call everything except the jobs from the GL thread.
+export class ModelManager
+{
+private:
+    struct ImportedModel
+    {
+        std::shared_ptr<Model> model;
+        ModelData data;
+        double importMs;
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<Model>> models;
+    size_t pendingCount = 0;
+
+    ThreadPool* threadPool;
+    TextureManager* textureManager;
+    bool asyncLoading = true;
+
+    std::mutex completedMutex;
+    std::vector<ImportedModel> completed;
+    std::vector<ImportedModel> ready;
+    std::atomic<size_t> inFlight{0};
+
+    ModelLoadStats stats;
+
+    static ImportedModel Import(std::shared_ptr<Model> model, const std::string& path)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ModelData data = Model::Import(path);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        return { std::move(model), std::move(data), elapsed.count() };
+    }
+
+    void Finish(ImportedModel& imported)
+    {
+        pendingCount--;
+        stats.importMs += imported.importMs;
+
+        // Failed imports still resolve the handle, as a model with no meshes
+        bool valid = imported.data.valid;
+
+        auto start = std::chrono::steady_clock::now();
+        imported.model->Build(std::move(imported.data), *textureManager);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        stats.buildMs += elapsed.count();
+        if (valid)
+            stats.built++;
+        else
+            stats.failed++;
+    }
+
+public:
+    ModelManager(TextureManager* tm, ThreadPool* pool = nullptr)
+        : threadPool(pool), textureManager(tm)
+    {}
+
+    ~ModelManager()
+    {
+        WaitForImports();
+    }
+
+    ModelManager(const ModelManager&) = delete;
+    ModelManager& operator=(const ModelManager&) = delete;
+
+    // Returns immediately. The model has no meshes until IsReady(); concurrent
+    // requests for the same path share one import.
+    std::shared_ptr<Model> LoadModel(const std::string& path)
+    {
+        stats.requested++;
+
+        auto it = models.find(path);
+        if (it != models.end())
+        {
+            stats.deduplicated++;
+            return it->second;
+        }
+
+        auto model = std::make_shared<Model>();
+        models[path] = model;
+        pendingCount++;
+
+        if (!threadPool || !asyncLoading)
+        {
+            ImportedModel imported = Import(model, path);
+            Finish(imported);
+            return model;
+        }
+
+        inFlight.fetch_add(1, std::memory_order_relaxed);
+        threadPool->Submit([this, model, path]()
+        {
+            if (!threadPool->IsCancelled())
+            {
+                ImportedModel imported = Import(model, path);
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completed.push_back(std::move(imported));
+            }
+
+            if (inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                inFlight.notify_all();
+        });
+
+        Logger::Log(LogLevel::DEBUG, LogCategory::RENDERING, "Queued model load: " + path);
+        return model;
+    }
+
+    // Builds imported models until the budget is spent, at least one per call.
+    // A budget <= 0 builds everything available.
+    size_t ProcessUploads(double budgetMs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            for (auto& imported : completed)
+                ready.push_back(std::move(imported));
+            completed.clear();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t finished = 0;
+
+        while (finished < ready.size())
+        {
+            Finish(ready[finished++]);
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if (budgetMs > 0.0 && elapsed.count() >= budgetMs)
+                break;
+        }
+
+        ready.erase(ready.begin(), ready.begin() + finished);
+        return finished;
+    }
+
+    void WaitForImports()
+    {
+        size_t remaining;
+        while ((remaining = inFlight.load(std::memory_order_acquire)) != 0)
+            inFlight.wait(remaining);
+    }
+
+    void UnloadModel(const std::string& path) { models.erase(path); }
+
+    void SetAsyncLoading(bool enabled) { asyncLoading = enabled; }
+
+    size_t GetPendingCount() const { return pendingCount; }
+    size_t GetModelCount() const { return models.size(); }
+    const ModelLoadStats& GetStats() const { return stats; }
+};
@@ -5,22 +5,50 @@ module;
 #include <glm/glm.hpp>
 
 #include <string>
+#include <vector>
 #include <unordered_map>
 #include <memory>
 #include <utility>
+#include <cstdint>
 
 export module XEngine.Resource.Shader.ShaderManager;
 
 import XEngine.Core.Logger;
+import XEngine.Core.Profiler;
+
+import XEngine.Rendering.Buffer;
+import XEngine.Rendering.UniformBlocks;
 
 import XEngine.Resource.Shader.ShaderLoader;
 import XEngine.Resource.Shader.ShaderCompiler;
 import XEngine.Resource.Shader.ShaderConfigLoader;
 
+// Index of a shader inside its ShaderManager. Stays valid across hot reloads.
+export struct ShaderHandle
+{
+    uint32_t index = UINT32_MAX;
+
+    bool IsValid() const { return index != UINT32_MAX; }
+    bool operator == (const ShaderHandle& other) const = default;
+};
+
+// Uniform name registered once with ShaderManager::GetUniform and resolved
+// against every program at link time, so setting it never touches a string.
+export struct UniformHandle
+{
+    uint32_t id = UINT32_MAX;
+
+    bool IsValid() const { return id != UINT32_MAX; }
+};
+
 export struct ShaderObj
 {
     GLuint ID;
     std::string name;
+    uint32_t handle = UINT32_MAX;
+
+    std::unordered_map<std::string, GLint> uniformLocations; // reflected at link time
+    std::vector<GLint> resolvedUniforms;                     // indexed by UniformHandle::id
 
     bool IsValid() const { return ID != 0; }
 
@@ -36,6 +64,13 @@ export class ShaderManager
     ShaderSource source;
 
     std::unordered_map<std::string, std::unique_ptr<ShaderObj>> shaders;
+    std::vector<ShaderObj*> handles;
+
+    std::vector<std::string> uniformNames;
+    std::unordered_map<std::string, uint32_t> uniformIDs;
+
+    std::unique_ptr<UniformBuffer> cameraBlock;
+    std::unique_ptr<UniformBuffer> lightsBlock;
 
     std::string runtimePath = "assets/shaders/"; 
     std::string sourcePath = "../assets/shaders/";
@@ -49,6 +84,11 @@ public:
 
     void Load()
     {
+        if (!cameraBlock)
+            cameraBlock = std::make_unique<UniformBuffer>(sizeof(CameraBlock), CAMERA_BLOCK_BINDING);
+        if (!lightsBlock)
+            lightsBlock = std::make_unique<UniformBuffer>(sizeof(LightsBlock), LIGHTS_BLOCK_BINDING);
+
         const std::vector<ShaderConfig> &shaderConfigs = scl.LoadShaderConfigs(shaderConfigsFilePath);
 
         for (auto& config : shaderConfigs)
@@ -79,8 +119,10 @@ public:
             auto shader = std::make_unique<ShaderObj>();
             shader->ID = glID;
             shader->name = config.name;
+            shader->handle = static_cast<uint32_t>(handles.size());
+            LinkUniforms(*shader);
 
-            ShaderObj* shaderPtr = shader.get();
+            handles.push_back(shader.get());
             shaders[config.name] = std::move(shader);
 
             Logger::Log(LogLevel::INFO, "Shader loaded: " + config.name + " (GL ID: " + std::to_string(glID) + ")");
@@ -135,6 +177,7 @@ public:
         glDeleteProgram(oldID);
 
         oldShader->ID = newID;
+        LinkUniforms(*oldShader);
 
         if (currentShader == oldID) 
         {
@@ -188,6 +231,7 @@ public:
             glDeleteProgram(oldID);
 
             oldShader->ID = newID;
+            LinkUniforms(*oldShader);
 
             if (currentShader == oldID) 
             {
@@ -212,6 +256,7 @@ public:
             if (id != 0)
                 glDeleteProgram(id);
 
+            handles[it->second->handle] = nullptr;
             shaders.erase(it);
             Logger::Log(LogLevel::INFO, "Shader unloaded: " + name);
         }
@@ -220,10 +265,22 @@ public:
     void Bind(const std::string& name) 
     {
         ShaderObj* shader = GetShader(name);
-        if (shader && shader->IsValid())
+        if (shader && shader->IsValid() && shader->ID != currentShader)
         {
             glUseProgram(shader->ID);
             currentShader = shader->ID;
+            Profiler::Count(ProfileCounter::SHADER_BINDS);
+        }
+    }
+
+    void Bind(ShaderHandle handle)
+    {
+        ShaderObj* shader = GetShader(handle);
+        if (shader && shader->IsValid() && shader->ID != currentShader)
+        {
+            glUseProgram(shader->ID);
+            currentShader = shader->ID;
+            Profiler::Count(ProfileCounter::SHADER_BINDS);
         }
     }
 
@@ -240,49 +297,120 @@ public:
                 glDeleteProgram(shader->ID);
 
         shaders.clear();
+        handles.clear();
+        cameraBlock.reset();
+        lightsBlock.reset();
         currentShader = 0;
     }
 
+    // ───── uniform handles ─────
+
+    UniformHandle GetUniform(const std::string& variableName)
+    {
+        auto it = uniformIDs.find(variableName);
+        if (it != uniformIDs.end())
+            return { it->second };
+
+        uint32_t id = static_cast<uint32_t>(uniformNames.size());
+        uniformNames.push_back(variableName);
+        uniformIDs[variableName] = id;
+
+        for (ShaderObj* shader : handles)
+            if (shader)
+                shader->resolvedUniforms.push_back(FindLocation(*shader, variableName));
+
+        return { id };
+    }
+
+    GLint GetLocation(ShaderHandle handle, UniformHandle uniform) const
+    {
+        if (handle.index >= handles.size() || !handles[handle.index])
+            return -1;
+
+        const std::vector<GLint>& resolved = handles[handle.index]->resolvedUniforms;
+        return uniform.id < resolved.size() ? resolved[uniform.id] : -1;
+    }
+
+    void SetBool(ShaderHandle shader, UniformHandle uniform, bool v) const
+    { glUniform1i(GetLocation(shader, uniform), (int)v); }
+
+    void SetInt(ShaderHandle shader, UniformHandle uniform, int v) const
+    { glUniform1i(GetLocation(shader, uniform), v); }
+
+    void SetFloat(ShaderHandle shader, UniformHandle uniform, float v) const
+    { glUniform1f(GetLocation(shader, uniform), v); }
+
+    void SetVec2(ShaderHandle shader, UniformHandle uniform, const glm::vec2& v) const
+    { glUniform2fv(GetLocation(shader, uniform), 1, &v[0]); }
+
+    void SetVec3(ShaderHandle shader, UniformHandle uniform, const glm::vec3& v) const
+    { glUniform3fv(GetLocation(shader, uniform), 1, &v[0]); }
+
+    void SetVec4(ShaderHandle shader, UniformHandle uniform, const glm::vec4& v) const
+    { glUniform4fv(GetLocation(shader, uniform), 1, &v[0]); }
+
+    void SetMat4(ShaderHandle shader, UniformHandle uniform, const glm::mat4& m) const
+    { glUniformMatrix4fv(GetLocation(shader, uniform), 1, GL_FALSE, &m[0][0]); }
+
+    // ───── shared uniform blocks ─────
+
+    void UpdateCameraBlock(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& viewPos)
+    {
+        if (!cameraBlock)
+            return;
+
+        CameraBlock block{ projection, view, glm::vec4(viewPos, 1.0f) };
+        cameraBlock->SetData(&block, sizeof(block));
+    }
+
+    void UpdateLightsBlock(const LightsBlock& block)
+    {
+        if (lightsBlock)
+            lightsBlock->SetData(&block, sizeof(block));
+    }
+
+    // ───── name-based setters (cold paths) ─────
+
     void SetBool(const std::string& shaderName, const std::string& variableName, bool v) const
     {
         ShaderObj* shader = GetShader(shaderName);
         if (shader && shader->IsValid())
-            glUniform1i(glGetUniformLocation(shader->ID, variableName.c_str()), (int)v);
+            glUniform1i(FindLocation(*shader, variableName), (int)v);
     }
 
     void SetInt(const std::string& shaderName, const std::string& variableName, int v) const
     {
         ShaderObj* shader = GetShader(shaderName);
         if (shader && shader->IsValid())
-            glUniform1i(glGetUniformLocation(shader->ID, variableName.c_str()), v);
+            glUniform1i(FindLocation(*shader, variableName), v);
     }
 
     void SetFloat(const std::string& shaderName, const std::string& variableName, float v) const
     {
         ShaderObj* shader = GetShader(shaderName);
         if (shader && shader->IsValid())
-            glUniform1f(glGetUniformLocation(shader->ID, variableName.c_str()), v);
+            glUniform1f(FindLocation(*shader, variableName), v);
     }
 
     void SetVec2(const std::string& shaderName, const std::string& variableName, const glm::vec2& v) const
     {
         ShaderObj* shader = GetShader(shaderName);
         if (shader && shader->IsValid())
-            glUniform2fv(glGetUniformLocation(shader->ID, variableName.c_str()), 1, &v[0]);
+            glUniform2fv(FindLocation(*shader, variableName), 1, &v[0]);
     }
 
     void SetVec3(const std::string& shaderName, const std::string& variableName, const glm::vec3& v) const
     {
         ShaderObj* shader = GetShader(shaderName);
         if (shader && shader->IsValid())
-            glUniform3fv(glGetUniformLocation(shader->ID, variableName.c_str()), 1, &v[0]);
+            glUniform3fv(FindLocation(*shader, variableName), 1, &v[0]);
     }
 
     void SetVec4(const std::string& shaderName, const std::string& variableName, const glm::vec4& v) const
     {
         ShaderObj* shader = GetShader(shaderName);
         if (shader && shader->IsValid())
-            glUniform4fv(glGetUniformLocation(shader->ID, variableName.c_str()), 1, &v[0]);
+            glUniform4fv(FindLocation(*shader, variableName), 1, &v[0]);
     }
 
     void SetMat4(const std::string& shaderName, const std::string& variableName, const glm::mat4& m) const
@@ -290,7 +418,7 @@ public:
         ShaderObj* shader = GetShader(shaderName);
         if (shader && shader->IsValid())
             glUniformMatrix4fv(
-            glGetUniformLocation(shader->ID, variableName.c_str()),
+            FindLocation(*shader, variableName),
             1, GL_FALSE, &m[0][0]);
     }
 
@@ -303,6 +431,17 @@ public:
         return nullptr;
     }
 
+    ShaderObj* GetShader(ShaderHandle handle) const
+    {
+        return handle.index < handles.size() ? handles[handle.index] : nullptr;
+    }
+
+    ShaderHandle GetHandle(const std::string& name) const
+    {
+        ShaderObj* shader = GetShader(name);
+        return shader ? ShaderHandle{ shader->handle } : ShaderHandle{};
+    }
+
     GLuint GetCurrentShader() { return currentShader; }
     size_t GetCount() { return shaders.size(); }
 
@@ -311,4 +450,67 @@ public:
 
     bool IsShaderValid(const std::string& name) const
     { return GetShader(name)->IsValid(); }
+
+private:
+    // Called after every successful link: reflects the active uniforms, re-resolves
+    // all registered handles and attaches the shared uniform blocks.
+    void LinkUniforms(ShaderObj& shader)
+    {
+        shader.uniformLocations.clear();
+
+        GLint count = 0;
+        GLint maxLength = 0;
+        glGetProgramiv(shader.ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(shader.ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::vector<char> nameBuffer(maxLength > 0 ? maxLength : 1);
+        for (GLint i = 0; i < count; i++)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(shader.ID, i, maxLength, &length, &size, &type, nameBuffer.data());
+
+            std::string uniformName(nameBuffer.data(), length);
+            GLint location = glGetUniformLocation(shader.ID, uniformName.c_str());
+            if (location < 0)
+                continue; // member of a uniform block
+
+            shader.uniformLocations[uniformName] = location;
+
+            // Arrays of basic types are reported once as "name[0]"
+            if (uniformName.ends_with("[0]"))
+            {
+                std::string base = uniformName.substr(0, uniformName.size() - 3);
+                shader.uniformLocations[base] = location;
+
+                for (GLint e = 1; e < size; e++)
+                {
+                    std::string element = base + "[" + std::to_string(e) + "]";
+                    shader.uniformLocations[element] = glGetUniformLocation(shader.ID, element.c_str());
+                }
+            }
+        }
+
+        shader.resolvedUniforms.resize(uniformNames.size());
+        for (size_t id = 0; id < uniformNames.size(); id++)
+            shader.resolvedUniforms[id] = FindLocation(shader, uniformNames[id]);
+
+        GLuint cameraIndex = glGetUniformBlockIndex(shader.ID, CAMERA_BLOCK_NAME);
+        if (cameraIndex != GL_INVALID_INDEX)
+            glUniformBlockBinding(shader.ID, cameraIndex, CAMERA_BLOCK_BINDING);
+
+        GLuint lightsIndex = glGetUniformBlockIndex(shader.ID, LIGHTS_BLOCK_NAME);
+        if (lightsIndex != GL_INVALID_INDEX)
+            glUniformBlockBinding(shader.ID, lightsIndex, LIGHTS_BLOCK_BINDING);
+
+        Logger::Log(LogLevel::DEBUG, "Shader '" + shader.name + "' reflected " + 
+            std::to_string(shader.uniformLocations.size()) + " uniforms");
+    }
+
+    static GLint FindLocation(const ShaderObj& shader, const std::string& variableName)
+    {
+        auto it = shader.uniformLocations.find(variableName);
+        return it != shader.uniformLocations.end() ? it->second : -1;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,249 @@
+module;
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+export module XEngine.Resource.Texture.BlockCompression;
+
+// CPU encoders for the BCn block formats, used when cooking the texture cache.
+// Every block covers 4x4 texels; input is always 16 RGBA8 texels in row order.
+export class BlockCompression
+{
+private:
+    struct Color
+    {
+        float r, g, b;
+    };
+
+    static uint16_t To565(const Color& c)
+    {
+        auto quantize = [](float v, float max) { return static_cast<uint16_t>(std::clamp(v * max / 255.0f + 0.5f, 0.0f, max)); };
+        return static_cast<uint16_t>((quantize(c.r, 31.0f) << 11) | (quantize(c.g, 63.0f) << 5) | quantize(c.b, 31.0f));
+    }
+
+    static Color From565(uint16_t v)
+    {
+        int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+        return { static_cast<float>((r << 3) | (r >> 2)),
+                 static_cast<float>((g << 2) | (g >> 4)),
+                 static_cast<float>((b << 3) | (b >> 2)) };
+    }
+
+    static float Distance(const Color& a, const Color& b)
+    {
+        float dr = a.r - b.r, dg = a.g - b.g, db = a.b - b.b;
+        return dr * dr + dg * dg + db * db;
+    }
+
+    // Picks the nearest of the four palette entries for every texel; returns the total error
+    static float AssignIndices(const Color* texels, uint16_t c0, uint16_t c1, uint32_t& indices)
+    {
+        Color p0 = From565(c0), p1 = From565(c1);
+        Color palette[4] = {
+            p0, p1,
+            { (2 * p0.r + p1.r) / 3, (2 * p0.g + p1.g) / 3, (2 * p0.b + p1.b) / 3 },
+            { (p0.r + 2 * p1.r) / 3, (p0.g + 2 * p1.g) / 3, (p0.b + 2 * p1.b) / 3 },
+        };
+
+        float error = 0.0f;
+        indices = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0;
+            float bestDistance = Distance(texels[i], palette[0]);
+            for (int p = 1; p < 4; p++)
+            {
+                float d = Distance(texels[i], palette[p]);
+                if (d < bestDistance)
+                {
+                    bestDistance = d;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (i * 2);
+            error += bestDistance;
+        }
+        return error;
+    }
+
+    // Keeps color0 > color1 so the block decodes in four-colour mode
+    static void WriteColorBlock(uint16_t c0, uint16_t c1, uint32_t indices, uint8_t* out)
+    {
+        if (c0 < c1)
+        {
+            std::swap(c0, c1);
+            indices ^= 0x55555555;      // 0<->1, 2<->3
+        }
+        else if (c0 == c1)
+        {
+            indices = 0;
+        }
+
+        std::memcpy(out, &c0, 2);
+        std::memcpy(out + 2, &c1, 2);
+        std::memcpy(out + 4, &indices, 4);
+    }
+
+    static void EncodeColor(const uint8_t* rgba, uint8_t* out)
+    {
+        Color texels[16];
+        Color mean{ 0, 0, 0 };
+        for (int i = 0; i < 16; i++)
+        {
+            texels[i] = { float(rgba[i * 4]), float(rgba[i * 4 + 1]), float(rgba[i * 4 + 2]) };
+            mean.r += texels[i].r; mean.g += texels[i].g; mean.b += texels[i].b;
+        }
+        mean.r /= 16; mean.g /= 16; mean.b /= 16;
+
+        // Principal axis of the block's colours by power iteration on the covariance
+        float cov[6] = {};
+        for (const Color& t : texels)
+        {
+            float r = t.r - mean.r, g = t.g - mean.g, b = t.b - mean.b;
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+
+        Color axis{ 1, 1, 1 };
+        for (int iteration = 0; iteration < 4; iteration++)
+        {
+            Color next{ cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b,
+                        cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b,
+                        cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b };
+            float length = std::max({ std::fabs(next.r), std::fabs(next.g), std::fabs(next.b) });
+            if (length < 1e-6f)
+                break;
+            axis = { next.r / length, next.g / length, next.b / length };
+        }
+
+        float minDot = 1e30f, maxDot = -1e30f;
+        Color minColor = texels[0], maxColor = texels[0];
+        for (const Color& t : texels)
+        {
+            float d = t.r * axis.r + t.g * axis.g + t.b * axis.b;
+            if (d < minDot) { minDot = d; minColor = t; }
+            if (d > maxDot) { maxDot = d; maxColor = t; }
+        }
+
+        uint16_t c0 = To565(maxColor), c1 = To565(minColor);
+        uint32_t indices;
+        float error = AssignIndices(texels, c0, c1, indices);
+
+        // One least-squares refit of the endpoints against the chosen indices
+        static constexpr float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0, bb = 0, ab = 0;
+        Color ax{ 0, 0, 0 }, bx{ 0, 0, 0 };
+        for (int i = 0; i < 16; i++)
+        {
+            float a = weights[(indices >> (i * 2)) & 3], b = 1.0f - a;
+            aa += a * a; bb += b * b; ab += a * b;
+            ax.r += a * texels[i].r; ax.g += a * texels[i].g; ax.b += a * texels[i].b;
+            bx.r += b * texels[i].r; bx.g += b * texels[i].g; bx.b += b * texels[i].b;
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) > 1e-6f)
+        {
+            float f = 1.0f / determinant;
+            Color e0{ (ax.r * bb - bx.r * ab) * f, (ax.g * bb - bx.g * ab) * f, (ax.b * bb - bx.b * ab) * f };
+            Color e1{ (bx.r * aa - ax.r * ab) * f, (bx.g * aa - ax.g * ab) * f, (bx.b * aa - ax.b * ab) * f };
+
+            uint16_t r0 = To565(e0), r1 = To565(e1);
+            uint32_t refitIndices;
+            float refitError = AssignIndices(texels, r0, r1, refitIndices);
+            if (refitError < error)
+            {
+                c0 = r0;
+                c1 = r1;
+                indices = refitIndices;
+            }
+        }
+
+        WriteColorBlock(c0, c1, indices, out);
+    }
+
+    // BC4 block of one channel; stride is the distance between texels in bytes
+    static void EncodeChannel(const uint8_t* values, int stride, uint8_t* out)
+    {
+        uint8_t lo = 255, hi = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            lo = std::min(lo, values[i * stride]);
+            hi = std::max(hi, values[i * stride]);
+        }
+
+        out[0] = hi;
+        out[1] = lo;
+
+        uint64_t bits = 0;
+        if (hi > lo)
+        {
+            // Eight-value mode: code 0 = hi, 1 = lo, 2..7 step from hi towards lo
+            float scale = 7.0f / (hi - lo);
+            for (int i = 0; i < 16; i++)
+            {
+                int position = static_cast<int>((values[i * stride] - lo) * scale + 0.5f);
+                uint64_t code = position == 7 ? 0 : position == 0 ? 1 : static_cast<uint64_t>(8 - position);
+                bits |= code << (i * 3);
+            }
+        }
+
+        for (int i = 0; i < 6; i++)
+            out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+
+public:
+    static constexpr size_t BC1_BLOCK_SIZE = 8;
+    static constexpr size_t BC3_BLOCK_SIZE = 16;
+    static constexpr size_t BC4_BLOCK_SIZE = 8;
+    static constexpr size_t BC5_BLOCK_SIZE = 16;
+
+    static void EncodeBC1(const uint8_t* rgba, uint8_t* out) { EncodeColor(rgba, out); }
+
+    static void EncodeBC3(const uint8_t* rgba, uint8_t* out)
+    {
+        EncodeChannel(rgba + 3, 4, out);
+        EncodeColor(rgba, out + 8);
+    }
+
+    static void EncodeBC4(const uint8_t* rgba, uint8_t* out)
+    {
+        EncodeChannel(rgba, 4, out);
+    }
+
+    static void EncodeBC5(const uint8_t* rgba, uint8_t* out)
+    {
+        EncodeChannel(rgba, 4, out);
+        EncodeChannel(rgba + 1, 4, out + 8);
+    }
+
+    // Compresses a whole RGBA8 image; edge blocks repeat the last row/column
+    template<typename Encoder>
+    static void CompressImage(const uint8_t* rgba, int width, int height, size_t blockSize, uint8_t* out, Encoder encode)
+    {
+        uint8_t block[16 * 4];
+        const int blocksX = (width + 3) / 4;
+        const int blocksY = (height + 3) / 4;
+
+        for (int by = 0; by < blocksY; by++)
+        {
+            for (int bx = 0; bx < blocksX; bx++)
+            {
+                for (int y = 0; y < 4; y++)
+                {
+                    int sy = std::min(by * 4 + y, height - 1);
+                    for (int x = 0; x < 4; x++)
+                    {
+                        int sx = std::min(bx * 4 + x, width - 1);
+                        std::memcpy(&block[(y * 4 + x) * 4], &rgba[(static_cast<size_t>(sy) * width + sx) * 4], 4);
+                    }
+                }
+
+                encode(block, out);
+                out += blockSize;
+            }
+        }
+    }
+};
@@ -0,0 +1,675 @@
+module;
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+export module XEngine.Resource.Texture.TextureCache;
+
+import XEngine.Core.Logger;
+import XEngine.Core.MappedFile;
+
+import XEngine.Resource.Texture.BlockCompression;
+
+// Not in the core profile loader; advertised through GL_EXT_texture_compression_s3tc
+constexpr GLenum COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+constexpr GLenum COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+
+export enum class TextureUsage
+{
+    COLOR,      // sRGB-encoded colour, mips filtered in linear light
+    NORMAL,     // tangent-space normal map; only XY is stored, Z is rebuilt in the shader
+    DATA        // single linear channel (height, displacement)
+};
+
+export enum class TextureFormat : uint32_t
+{
+    RGBA8,
+    RG8,
+    R8,
+    BC1,
+    BC3,
+    BC4,
+    BC5
+};
+
+export struct TextureFormatInfo
+{
+    const char* name;
+    GLenum internalFormat;
+    GLenum baseFormat;
+    size_t bytesPerBlock;   // per texel when uncompressed
+    bool   compressed;
+};
+
+export const TextureFormatInfo& GetTextureFormatInfo(TextureFormat format)
+{
+    static const TextureFormatInfo formats[] = {
+        { "RGBA8", GL_RGBA8,                   GL_RGBA, 4,  false },
+        { "RG8",   GL_RG8,                     GL_RG,   2,  false },
+        { "R8",    GL_R8,                      GL_RED,  1,  false },
+        { "BC1",   COMPRESSED_RGB_S3TC_DXT1,   GL_RGB,  8,  true },
+        { "BC3",   COMPRESSED_RGBA_S3TC_DXT5,  GL_RGBA, 16, true },
+        { "BC4",   GL_COMPRESSED_RED_RGTC1,    GL_RED,  8,  true },
+        { "BC5",   GL_COMPRESSED_RG_RGTC2,     GL_RG,   16, true },
+    };
+    return formats[static_cast<uint32_t>(format)];
+}
+
+export struct TextureLevel
+{
+    int    width = 0;
+    int    height = 0;
+    size_t offset = 0;      // first face, from the start of the container
+    size_t faceSize = 0;    // bytes of one face, faces follow each other
+};
+
+// A parsed KTX 1.1 container, backed either by a mapping of the cache file or
+// by the freshly cooked bytes
+export struct CookedTexture
+{
+    TextureFormat format = TextureFormat::RGBA8;
+    int  width = 0;
+    int  height = 0;
+    int  faces = 1;
+    int  channels = 0;      // of the source image
+    bool fromCache = false;
+    bool valid = false;
+
+    std::vector<TextureLevel> levels;
+
+    std::shared_ptr<MappedFile> mapping;
+    std::vector<uint8_t> storage;
+
+    const uint8_t* GetBase() const { return mapping ? mapping->GetData() : storage.data(); }
+    size_t GetSize() const { return mapping ? mapping->GetSize() : storage.size(); }
+
+    const uint8_t* GetData(size_t level, int face) const
+    {
+        return GetBase() + levels[level].offset + static_cast<size_t>(face) * levels[level].faceSize;
+    }
+
+    size_t GetMemorySize() const
+    {
+        size_t bytes = 0;
+        for (const auto& level : levels)
+            bytes += level.faceSize * faces;
+        return bytes;
+    }
+};
+
+// Builds and reads the on-disk texture cache. Entries are KTX 1.1 files holding
+// the full mip chain in the final GPU format, named after a hash of the source
+// bytes, so an edited source simply misses and is cooked again.
+// Load is safe to call from worker threads.
+export class TextureCache
+{
+private:
+    static constexpr uint8_t KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static constexpr uint32_t KTX_ENDIANNESS = 0x04030201;
+    static constexpr const char* HASH_KEY = "XEngine.sourceHash";
+    static constexpr const char* CHANNELS_KEY = "XEngine.channels";
+
+    struct KTXHeader
+    {
+        uint8_t  identifier[12];
+        uint32_t endianness;
+        uint32_t glType;
+        uint32_t glTypeSize;
+        uint32_t glFormat;
+        uint32_t glInternalFormat;
+        uint32_t glBaseInternalFormat;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t numberOfArrayElements;
+        uint32_t numberOfFaces;
+        uint32_t numberOfMipmapLevels;
+        uint32_t bytesOfKeyValueData;
+    };
+
+    static_assert(sizeof(KTXHeader) == 64);
+
+    std::string directory;
+    bool compression = true;
+    bool s3tcSupported = false;
+    mutable std::atomic<uint32_t> tempCounter{0};
+
+    static size_t Align4(size_t value) { return (value + 3) & ~size_t(3); }
+
+    // ───── Hashing ─────
+
+    static uint64_t Mix(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static uint64_t HashBytes(const uint8_t* data, size_t size, uint64_t seed)
+    {
+        const uint64_t k1 = 0x87c37b91114253d5ull, k2 = 0x4cf5ad432745937full;
+        uint64_t h = seed ^ (size * k1);
+
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            word *= k1;
+            word = (word << 31) | (word >> 33);
+            word *= k2;
+            h ^= word;
+            h = ((h << 27) | (h >> 37)) * 5 + 0x52dce729;
+        }
+
+        uint64_t tail = 0;
+        for (size_t j = 0; i + j < size; j++)
+            tail |= static_cast<uint64_t>(data[i + j]) << (j * 8);
+        h ^= Mix(tail ^ k2);
+
+        return Mix(h);
+    }
+
+    // ───── Mip generation ─────
+
+    static float SRGBToLinear(float c)
+    {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float LinearToSRGB(float c)
+    {
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    static std::vector<float> ToFloat(const uint8_t* rgba, size_t texels, TextureUsage usage)
+    {
+        static const auto srgbTable = []()
+        {
+            std::vector<float> table(256);
+            for (int i = 0; i < 256; i++)
+                table[i] = SRGBToLinear(i / 255.0f);
+            return table;
+        }();
+
+        std::vector<float> out(texels * 4);
+        for (size_t i = 0; i < texels * 4; i++)
+        {
+            bool alpha = (i & 3) == 3;
+            if (usage == TextureUsage::COLOR && !alpha)
+                out[i] = srgbTable[rgba[i]];
+            else if (usage == TextureUsage::NORMAL && !alpha)
+                out[i] = rgba[i] / 127.5f - 1.0f;
+            else
+                out[i] = rgba[i] / 255.0f;
+        }
+        return out;
+    }
+
+    static std::vector<uint8_t> ToBytes(const std::vector<float>& texels, TextureUsage usage)
+    {
+        std::vector<uint8_t> out(texels.size());
+        auto store = [](float v) { return static_cast<uint8_t>(std::clamp(v * 255.0f + 0.5f, 0.0f, 255.0f)); };
+
+        for (size_t i = 0; i < texels.size(); i += 4)
+        {
+            const float* t = &texels[i];
+            if (usage == TextureUsage::NORMAL)
+            {
+                float length = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+                float scale = length > 1e-6f ? 1.0f / length : 0.0f;
+                for (int c = 0; c < 3; c++)
+                    out[i + c] = store(t[c] * scale * 0.5f + 0.5f);
+            }
+            else if (usage == TextureUsage::COLOR)
+            {
+                for (int c = 0; c < 3; c++)
+                    out[i + c] = store(LinearToSRGB(std::clamp(t[c], 0.0f, 1.0f)));
+            }
+            else
+            {
+                for (int c = 0; c < 3; c++)
+                    out[i + c] = store(t[c]);
+            }
+            out[i + 3] = store(t[3]);
+        }
+        return out;
+    }
+
+    // Halves the image with a separable [1 3 3 1] / 8 kernel, clamping at the edges
+    static std::vector<float> Downsample(const std::vector<float>& src, int width, int height, int newWidth, int newHeight)
+    {
+        static constexpr float weights[4] = { 1.0f / 8, 3.0f / 8, 3.0f / 8, 1.0f / 8 };
+
+        std::vector<float> horizontal(static_cast<size_t>(newWidth) * height * 4, 0.0f);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < newWidth; x++)
+                for (int k = 0; k < 4; k++)
+                {
+                    int sx = std::clamp(2 * x - 1 + k, 0, width - 1);
+                    const float* s = &src[(static_cast<size_t>(y) * width + sx) * 4];
+                    float* d = &horizontal[(static_cast<size_t>(y) * newWidth + x) * 4];
+                    for (int c = 0; c < 4; c++)
+                        d[c] += s[c] * weights[k];
+                }
+
+        std::vector<float> out(static_cast<size_t>(newWidth) * newHeight * 4, 0.0f);
+        for (int y = 0; y < newHeight; y++)
+            for (int k = 0; k < 4; k++)
+            {
+                int sy = std::clamp(2 * y - 1 + k, 0, height - 1);
+                for (int x = 0; x < newWidth; x++)
+                {
+                    const float* s = &horizontal[(static_cast<size_t>(sy) * newWidth + x) * 4];
+                    float* d = &out[(static_cast<size_t>(y) * newWidth + x) * 4];
+                    for (int c = 0; c < 4; c++)
+                        d[c] += s[c] * weights[k];
+                }
+            }
+
+        return out;
+    }
+
+    // ───── Encoding ─────
+
+    static size_t GetLevelSize(TextureFormat format, int width, int height)
+    {
+        const TextureFormatInfo& info = GetTextureFormatInfo(format);
+        if (info.compressed)
+            return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * info.bytesPerBlock;
+
+        // KTX rows follow GL_UNPACK_ALIGNMENT 4
+        return Align4(width * info.bytesPerBlock) * height;
+    }
+
+    static void EncodeLevel(const uint8_t* rgba, int width, int height, TextureFormat format, uint8_t* out)
+    {
+        const TextureFormatInfo& info = GetTextureFormatInfo(format);
+        switch (format)
+        {
+        case TextureFormat::BC1:
+            BlockCompression::CompressImage(rgba, width, height, info.bytesPerBlock, out, BlockCompression::EncodeBC1);
+            return;
+        case TextureFormat::BC3:
+            BlockCompression::CompressImage(rgba, width, height, info.bytesPerBlock, out, BlockCompression::EncodeBC3);
+            return;
+        case TextureFormat::BC4:
+            BlockCompression::CompressImage(rgba, width, height, info.bytesPerBlock, out, BlockCompression::EncodeBC4);
+            return;
+        case TextureFormat::BC5:
+            BlockCompression::CompressImage(rgba, width, height, info.bytesPerBlock, out, BlockCompression::EncodeBC5);
+            return;
+        default:
+            break;
+        }
+
+        const size_t texelSize = info.bytesPerBlock;
+        const size_t rowSize = Align4(width * texelSize);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                std::memcpy(out + y * rowSize + x * texelSize, rgba + (static_cast<size_t>(y) * width + x) * 4, texelSize);
+    }
+
+    TextureFormat ChooseFormat(TextureUsage usage, bool hasAlpha) const
+    {
+        // RGTC is core since GL 3.0, S3TC still depends on the driver
+        switch (usage)
+        {
+        case TextureUsage::NORMAL: return compression ? TextureFormat::BC5 : TextureFormat::RG8;
+        case TextureUsage::DATA:   return compression ? TextureFormat::BC4 : TextureFormat::R8;
+        default:
+            if (compression && s3tcSupported)
+                return hasAlpha ? TextureFormat::BC3 : TextureFormat::BC1;
+            return TextureFormat::RGBA8;
+        }
+    }
+
+    std::string GetVariant(TextureUsage usage, int faces) const
+    {
+        std::string variant = faces == 6 ? "cube" : usage == TextureUsage::NORMAL ? "normal" : usage == TextureUsage::DATA ? "data" : "color";
+        bool compressed = compression && (usage != TextureUsage::COLOR || s3tcSupported);
+        return variant + (compressed ? "-bc" : "-raw");
+    }
+
+    // ───── KTX ─────
+
+    static std::vector<uint8_t> WriteKTX(const CookedTexture& texture, const std::vector<std::vector<uint8_t>>& levelData,
+                                         uint64_t hash)
+    {
+        const TextureFormatInfo& info = GetTextureFormatInfo(texture.format);
+
+        char hashText[17];
+        std::snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(hash));
+        const std::string channelsText = std::to_string(texture.channels);
+
+        std::vector<uint8_t> keyValues;
+        auto addKeyValue = [&keyValues](const std::string& key, const std::string& value)
+        {
+            uint32_t size = static_cast<uint32_t>(key.size() + 1 + value.size() + 1);
+            size_t at = keyValues.size();
+            keyValues.resize(at + 4 + Align4(size), 0);
+            std::memcpy(&keyValues[at], &size, 4);
+            std::memcpy(&keyValues[at + 4], key.c_str(), key.size() + 1);
+            std::memcpy(&keyValues[at + 4 + key.size() + 1], value.c_str(), value.size() + 1);
+        };
+        addKeyValue(HASH_KEY, hashText);
+        addKeyValue(CHANNELS_KEY, channelsText);
+
+        KTXHeader header{};
+        std::memcpy(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER));
+        header.endianness = KTX_ENDIANNESS;
+        header.glType = info.compressed ? 0 : GL_UNSIGNED_BYTE;
+        header.glTypeSize = 1;
+        header.glFormat = info.compressed ? 0 : info.baseFormat;
+        header.glInternalFormat = info.internalFormat;
+        header.glBaseInternalFormat = info.baseFormat;
+        header.pixelWidth = texture.width;
+        header.pixelHeight = texture.height;
+        header.numberOfFaces = texture.faces;
+        header.numberOfMipmapLevels = static_cast<uint32_t>(texture.levels.size());
+        header.bytesOfKeyValueData = static_cast<uint32_t>(keyValues.size());
+
+        std::vector<uint8_t> out(sizeof(header));
+        std::memcpy(out.data(), &header, sizeof(header));
+        out.insert(out.end(), keyValues.begin(), keyValues.end());
+
+        // levelData holds every face of a level back to back; all our formats are 4-byte multiples
+        for (size_t level = 0; level < texture.levels.size(); level++)
+        {
+            uint32_t imageSize = static_cast<uint32_t>(texture.levels[level].faceSize);
+            size_t at = out.size();
+            out.resize(at + 4);
+            std::memcpy(&out[at], &imageSize, 4);
+            out.insert(out.end(), levelData[level].begin(), levelData[level].end());
+        }
+
+        return out;
+    }
+
+    static bool ParseKTX(CookedTexture& texture, uint64_t expectedHash)
+    {
+        const uint8_t* base = texture.GetBase();
+        const size_t size = texture.GetSize();
+
+        KTXHeader header;
+        if (size < sizeof(header))
+            return false;
+        std::memcpy(&header, base, sizeof(header));
+
+        if (std::memcmp(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0 || header.endianness != KTX_ENDIANNESS)
+            return false;
+        if ((header.numberOfFaces != 1 && header.numberOfFaces != 6) || header.pixelDepth != 0 || header.numberOfArrayElements != 0)
+            return false;
+
+        bool known = false;
+        for (uint32_t f = 0; f <= static_cast<uint32_t>(TextureFormat::BC5); f++)
+        {
+            if (GetTextureFormatInfo(static_cast<TextureFormat>(f)).internalFormat == header.glInternalFormat)
+            {
+                texture.format = static_cast<TextureFormat>(f);
+                known = true;
+            }
+        }
+        if (!known)
+            return false;
+
+        size_t offset = sizeof(header);
+        const size_t keyValueEnd = offset + header.bytesOfKeyValueData;
+        if (keyValueEnd > size)
+            return false;
+
+        bool hashMatches = false;
+        while (offset + 4 <= keyValueEnd)
+        {
+            uint32_t pairSize;
+            std::memcpy(&pairSize, base + offset, 4);
+            offset += 4;
+            if (offset + pairSize > keyValueEnd)
+                return false;
+
+            const char* pair = reinterpret_cast<const char*>(base + offset);
+            std::string key(pair, strnlen(pair, pairSize));
+            std::string value = key.size() + 1 < pairSize ? std::string(pair + key.size() + 1, strnlen(pair + key.size() + 1, pairSize - key.size() - 1)) : "";
+
+            if (key == HASH_KEY)
+            {
+                char hashText[17];
+                std::snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(expectedHash));
+                hashMatches = value == hashText;
+            }
+            else if (key == CHANNELS_KEY)
+            {
+                texture.channels = std::atoi(value.c_str());
+            }
+
+            offset += Align4(pairSize);
+        }
+
+        if (!hashMatches)
+            return false;
+
+        texture.width = static_cast<int>(header.pixelWidth);
+        texture.height = static_cast<int>(header.pixelHeight);
+        texture.faces = static_cast<int>(header.numberOfFaces);
+        texture.levels.clear();
+
+        offset = keyValueEnd;
+        uint32_t levelCount = std::max(header.numberOfMipmapLevels, 1u);
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            TextureLevel entry;
+            entry.width = std::max(texture.width >> level, 1);
+            entry.height = std::max(texture.height >> level, 1);
+
+            uint32_t imageSize;
+            if (offset + 4 > size)
+                return false;
+            std::memcpy(&imageSize, base + offset, 4);
+            offset += 4;
+
+            entry.offset = offset;
+            entry.faceSize = imageSize;
+            if (imageSize != GetLevelSize(texture.format, entry.width, entry.height))
+                return false;
+
+            offset += Align4(imageSize) * texture.faces;
+            if (offset > size)
+                return false;
+
+            texture.levels.push_back(entry);
+        }
+
+        texture.valid = true;
+        return true;
+    }
+
+    CookedTexture Cook(const std::vector<std::unique_ptr<MappedFile>>& sources, const std::vector<std::string>& paths,
+                       TextureUsage usage, uint64_t hash) const
+    {
+        CookedTexture texture;
+        texture.faces = static_cast<int>(sources.size());
+
+        std::vector<std::unique_ptr<unsigned char, void(*)(void*)>> images;
+        bool hasAlpha = false;
+
+        for (size_t face = 0; face < sources.size(); face++)
+        {
+            int width, height, channels;
+            unsigned char* pixels = stbi_load_from_memory(sources[face]->GetData(), static_cast<int>(sources[face]->GetSize()),
+                                                          &width, &height, &channels, 4);
+            if (!pixels)
+            {
+                Logger::Log(LogLevel::ERROR, LogCategory::RENDERING, "Texture failed to decode: " + paths[face]);
+                return texture;
+            }
+            images.emplace_back(pixels, stbi_image_free);
+
+            if (face == 0)
+            {
+                texture.width = width;
+                texture.height = height;
+                texture.channels = channels;
+            }
+            else if (width != texture.width || height != texture.height)
+            {
+                Logger::Log(LogLevel::ERROR, LogCategory::RENDERING, "Cubemap face size mismatch: " + paths[face]);
+                return texture;
+            }
+
+            if (channels == 4)
+                for (size_t i = 3; i < static_cast<size_t>(width) * height * 4 && !hasAlpha; i += 4)
+                    hasAlpha = pixels[i] != 255;
+        }
+
+        texture.format = ChooseFormat(usage, hasAlpha);
+
+        // Cubemaps are sampled without mips by the skybox
+        int levelCount = 1;
+        if (texture.faces == 1)
+            levelCount = static_cast<int>(std::floor(std::log2(std::max(texture.width, texture.height)))) + 1;
+
+        std::vector<std::vector<uint8_t>> levelData(levelCount);
+        for (int face = 0; face < texture.faces; face++)
+        {
+            int width = texture.width, height = texture.height;
+            std::vector<uint8_t> bytes(images[face].get(), images[face].get() + static_cast<size_t>(width) * height * 4);
+            std::vector<float> linear;
+
+            for (int level = 0; level < levelCount; level++)
+            {
+                if (level > 0)
+                {
+                    if (linear.empty())
+                        linear = ToFloat(bytes.data(), static_cast<size_t>(width) * height, usage);
+
+                    int newWidth = std::max(width / 2, 1), newHeight = std::max(height / 2, 1);
+                    linear = Downsample(linear, width, height, newWidth, newHeight);
+                    width = newWidth;
+                    height = newHeight;
+
+                    bytes = ToBytes(linear, usage);
+                }
+
+                if (face == 0)
+                    texture.levels.push_back({ width, height, 0, GetLevelSize(texture.format, width, height) });
+
+                std::vector<uint8_t>& out = levelData[level];
+                size_t at = out.size();
+                out.resize(at + texture.levels[level].faceSize, 0);
+                EncodeLevel(bytes.data(), width, height, texture.format, out.data() + at);
+            }
+        }
+
+        texture.storage = WriteKTX(texture, levelData, hash);
+        texture.levels.clear();
+        ParseKTX(texture, hash);
+        return texture;
+    }
+
+    void Store(const CookedTexture& texture, const std::string& cachePath) const
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+
+        const std::string tempPath = cachePath + "." + std::to_string(tempCounter.fetch_add(1)) + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(texture.storage.data()), static_cast<std::streamsize>(texture.storage.size()));
+            if (!out)
+            {
+                Logger::Log(LogLevel::WARNING, LogCategory::RENDERING, "Cannot write texture cache: " + cachePath);
+                out.close();
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec)
+            std::filesystem::remove(tempPath, ec);
+    }
+
+public:
+    explicit TextureCache(std::string cacheDirectory = "assets/cache/textures")
+        : directory(std::move(cacheDirectory))
+    {}
+
+    // Render thread, before the first Load
+    void QueryFormatSupport()
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0)
+                s3tcSupported = true;
+        }
+
+        Logger::Log(LogLevel::INFO, LogCategory::RENDERING,
+            std::string("Texture compression: BC4/BC5 core, BC1/BC3 ") + (s3tcSupported ? "supported" : "not supported"));
+    }
+
+    void SetCompression(bool enabled) { compression = enabled; }
+    bool IsCompressionEnabled() const { return compression; }
+    bool IsS3TCSupported() const { return s3tcSupported; }
+
+    const std::string& GetDirectory() const { return directory; }
+
+    // Loads the cached container for these sources, cooking and storing it on a
+    // miss. One source is a 2D texture with mips, six are cubemap faces.
+    CookedTexture Load(const std::vector<std::string>& paths, TextureUsage usage) const
+    {
+        std::vector<std::unique_ptr<MappedFile>> sources;
+        uint64_t hash = 0x9e3779b97f4a7c15ull + static_cast<uint64_t>(usage);
+
+        for (const auto& path : paths)
+        {
+            auto source = std::make_unique<MappedFile>(path);
+            if (!source->IsValid())
+            {
+                Logger::Log(LogLevel::ERROR, LogCategory::RENDERING, "Texture failed to load at path: " + path);
+                return {};
+            }
+            hash = HashBytes(source->GetData(), source->GetSize(), hash);
+            sources.push_back(std::move(source));
+        }
+
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+        const std::string cachePath = directory + "/" + name + "-" + GetVariant(usage, static_cast<int>(paths.size())) + ".ktx";
+
+        if (std::filesystem::exists(cachePath))
+        {
+            CookedTexture cached;
+            cached.mapping = std::make_shared<MappedFile>(cachePath);
+            if (cached.mapping->IsValid() && ParseKTX(cached, hash) && cached.faces == static_cast<int>(paths.size()))
+            {
+                cached.fromCache = true;
+                return cached;
+            }
+
+            Logger::Log(LogLevel::WARNING, LogCategory::RENDERING, "Rebuilding invalid texture cache entry: " + cachePath);
+        }
+
+        CookedTexture texture = Cook(sources, paths, usage, hash);
+        if (texture.valid)
+            Store(texture, cachePath);
+        return texture;
+    }
+};
@@ -4,120 +4,672 @@ module;
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
 #include <stb_image.h>
 
 export module XEngine.Resource.Texture.TextureManager;
 
 import XEngine.Core.Logger;
+import XEngine.Core.ThreadPool;
+import XEngine.Core.Profiler;
 
+import XEngine.Resource.Texture.TextureCache;
+
+export struct TextureLoadStats
+{
+    size_t requested = 0;       // LoadTexture/LoadCubemap calls
+    size_t deduplicated = 0;    // requests answered from the cache or an in-flight load
+    size_t decoded = 0;         // images decoded (cubemap faces count separately)
+    size_t uploaded = 0;        // textures made resident
+    size_t failed = 0;
+    size_t cacheHits = 0;       // served from the texture cache
+    size_t cacheMisses = 0;     // cooked and written to the cache
+
+    double decodeMs = 0.0;      // summed over workers
+    double uploadMs = 0.0;      // render thread
+    size_t vramBytes = 0;       // resident textures, including mips
+};
+
+export struct TextureInfo
+{
+    std::string path;
+    std::string format;
+    int width = 0;
+    int height = 0;
+    int levels = 0;
+    size_t vramBytes = 0;
+    double loadMs = 0.0;        // decode or cache read plus upload
+    bool fromCache = false;
+};
+
+// Textures are created immediately and show the placeholder image until their
+// pixels arrive. Loading runs on the thread pool; uploads happen on the render
+// thread in ProcessUploads. With the cache enabled (default) workers map a
+// pre-built container with every mip level in its GPU format; otherwise images
+// are decoded, streamed through pixel buffer objects and mipmapped on the GPU.
+// All public methods must be called from the thread that owns the GL context.
 export class TextureManager
 {
 private:
+    static constexpr const char* PLACEHOLDER_PATH = "assets/textures/error.png";
+    static constexpr size_t PBO_COUNT = 4;
+
+    struct DecodedImage
+    {
+        uint64_t request = 0;
+        int face = -1;              // cubemap face, -1 for 2D textures
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::unique_ptr<unsigned char, void(*)(void*)> pixels{ nullptr, stbi_image_free };
+        CookedTexture cooked;       // all faces and levels when loaded through the cache
+        double decodeMs = 0.0;
+    };
+
+    struct PendingTexture
+    {
+        uint64_t request;
+        unsigned int id;
+        GLenum target;
+        std::string path;
+        std::vector<DecodedImage> faces;    // cubemaps upload once all six are in
+    };
+
     std::unordered_map<std::string, unsigned int> loadedTextures;
+    std::unordered_map<unsigned int, TextureInfo> textureInfo;
+    std::unordered_map<uint64_t, PendingTexture> pending;
+    uint64_t nextRequest = 1;
 
-    unsigned int LoadTextureFromFile(const char* path, bool gamma = false)
+    ThreadPool* threadPool;
+    bool asyncLoading = true;
+
+    TextureCache cache;
+    bool cacheEnabled = true;
+    bool formatsQueried = false;
+
+    // Written by workers, drained by ProcessUploads
+    std::mutex completedMutex;
+    std::vector<DecodedImage> completed;
+    std::deque<DecodedImage> ready;
+    std::atomic<size_t> inFlight{0};
+
+    DecodedImage placeholder;
+    unsigned int pbos[PBO_COUNT] = {};
+    size_t nextPbo = 0;
+
+    TextureLoadStats stats;
+    std::mutex statsMutex;
+
+    static GLenum FormatFor(int channels)
     {
-        unsigned int textureID;
-        glGenTextures(1, &textureID);
+        if (channels == 1) return GL_RED;
+        if (channels == 4) return GL_RGBA;
+        return GL_RGB;
+    }
 
-        int width, height, nrComponents;
-        unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-        if (!data)
+    // Colour textures keep the bare path as their key
+    static std::string MakeKey(const std::string& path, TextureUsage usage)
+    {
+        switch (usage)
         {
-            Logger::Log(LogLevel::ERROR, "Texture failed to load at path: " + std::string(path));
-            return 0;
+        case TextureUsage::NORMAL: return path + "#normal";
+        case TextureUsage::DATA:   return path + "#data";
+        default:                   return path;
         }
+    }
 
-        GLenum format = GL_RGB;
-        GLenum texWrap = GL_REPEAT;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) { format = GL_RGBA; texWrap = GL_CLAMP_TO_EDGE; }
+    static DecodedImage Decode(const std::string& path, uint64_t request, int face)
+    {
+        auto start = std::chrono::steady_clock::now();
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        DecodedImage image;
+        image.request = request;
+        image.face = face;
+        image.pixels.reset(stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0));
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        image.decodeMs = elapsed.count();
+        return image;
+    }
+
+    static DecodedImage LoadCached(const TextureCache& cache, const std::vector<std::string>& paths,
+                                   TextureUsage usage, uint64_t request)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        DecodedImage image;
+        image.request = request;
+        image.cooked = cache.Load(paths, usage);
+
+        if (image.cooked.valid && image.cooked.mapping)
+        {
+            // Fault the mapping in here rather than inside the GL calls on the render thread
+            const uint8_t* data = image.cooked.GetBase();
+            volatile uint8_t sink = 0;
+            for (size_t offset = 0; offset < image.cooked.GetSize(); offset += 4096)
+                sink = sink + data[offset];
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        image.decodeMs = elapsed.count();
+        return image;
+    }
+
+    const DecodedImage& GetPlaceholder()
+    {
+        if (!placeholder.pixels)
+        {
+            placeholder = Decode(PLACEHOLDER_PATH, 0, -1);
+            if (!placeholder.pixels)
+            {
+                // Magenta/black checker if the placeholder itself is missing
+                Logger::Log(LogLevel::WARNING, LogCategory::RENDERING,
+                    "Placeholder texture missing: " + std::string(PLACEHOLDER_PATH));
+
+                placeholder.width = placeholder.height = 8;
+                placeholder.channels = 4;
+                auto* pixels = static_cast<unsigned char*>(std::malloc(8 * 8 * 4));
+                for (int i = 0; i < 64; i++)
+                {
+                    bool odd = ((i % 8) + (i / 8)) % 2;
+                    pixels[i * 4 + 0] = odd ? 255 : 0;
+                    pixels[i * 4 + 1] = 0;
+                    pixels[i * 4 + 2] = odd ? 255 : 0;
+                    pixels[i * 4 + 3] = 255;
+                }
+                placeholder.pixels = { pixels, stbi_image_free };
+            }
+        }
+        return placeholder;
+    }
+
+    // Copies the pixels into the next PBO in the ring and specifies the image
+    // from it, so the driver can finish the transfer without stalling us
+    void UploadImage(GLenum target, const DecodedImage& image)
+    {
+        size_t size = static_cast<size_t>(image.width) * image.height * image.channels;
+        GLenum format = FormatFor(image.channels);
+
+        if (pbos[0] == 0)
+            glGenBuffers(PBO_COUNT, pbos);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[nextPbo]);
+        nextPbo = (nextPbo + 1) % PBO_COUNT;
+
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        Profiler::Count(ProfileCounter::BUFFER_UPLOADS);
+        Profiler::Count(ProfileCounter::UPLOAD_BYTES, size);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (mapped)
+        {
+            std::memcpy(mapped, image.pixels.get(), size);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexImage2D(target, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glTexImage2D(target, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.get());
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    // Specifies every level straight from the container; no PBO copy or mip generation
+    void UploadCooked(GLenum target, const CookedTexture& texture)
+    {
+        const TextureFormatInfo& info = GetTextureFormatInfo(texture.format);
+        const int levelCount = static_cast<int>(texture.levels.size());
+
+        for (int level = 0; level < levelCount; level++)
+        {
+            const TextureLevel& entry = texture.levels[level];
+            for (int face = 0; face < texture.faces; face++)
+            {
+                GLenum faceTarget = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+                if (info.compressed)
+                    glCompressedTexImage2D(faceTarget, level, info.internalFormat, entry.width, entry.height, 0,
+                        static_cast<GLsizei>(entry.faceSize), texture.GetData(level, face));
+                else
+                    glTexImage2D(faceTarget, level, info.internalFormat, entry.width, entry.height, 0,
+                        info.baseFormat, GL_UNSIGNED_BYTE, texture.GetData(level, face));
+            }
+        }
+
+        glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
 
+        if (target == GL_TEXTURE_2D)
+        {
+            GLenum texWrap = texture.channels == 4 ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texWrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texWrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        }
+        else
+        {
+            SetCubemapParameters();
+        }
+    }
+
+    void SetTexture2DParameters(int channels)
+    {
+        GLenum texWrap = channels == 4 ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+
+        glGenerateMipmap(GL_TEXTURE_2D);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texWrap);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texWrap);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
 
-        stbi_image_free(data);
-        return textureID;
+    void SetCubemapParameters()
+    {
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     }
 
-    unsigned int LoadCubemapFromFiles(const std::vector<std::string>& faces)
+    void RecordDecode(const DecodedImage& image)
     {
-        unsigned int textureID;
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.decoded++;
+        stats.decodeMs += image.decodeMs;
+    }
 
-        int width, height, nrComponents;
-        for (unsigned int i = 0; i < faces.size(); i++)
+    void QueueLoad(const std::vector<std::string>& paths, uint64_t request, TextureUsage usage)
+    {
+        if (!cacheEnabled)
+        {
+            for (size_t i = 0; i < paths.size(); i++)
+                QueueDecode(paths[i], request, paths.size() == 1 ? -1 : static_cast<int>(i));
+            return;
+        }
+
+        if (!threadPool || !asyncLoading)
         {
-            unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrComponents, 0);
-            if (data)
+            DecodedImage image = LoadCached(cache, paths, usage, request);
+            RecordDecode(image);
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.push_back(std::move(image));
+            return;
+        }
+
+        inFlight.fetch_add(1, std::memory_order_relaxed);
+        threadPool->Submit([this, paths, request, usage]()
+        {
+            if (!threadPool->IsCancelled())
+            {
+                DecodedImage image = LoadCached(cache, paths, usage, request);
+                RecordDecode(image);
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completed.push_back(std::move(image));
+            }
+
+            if (inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                inFlight.notify_all();
+        });
+    }
+
+    void QueueDecode(const std::string& path, uint64_t request, int face)
+    {
+        if (!threadPool || !asyncLoading)
+        {
+            DecodedImage image = Decode(path, request, face);
+            RecordDecode(image);
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.push_back(std::move(image));
+            return;
+        }
+
+        inFlight.fetch_add(1, std::memory_order_relaxed);
+        threadPool->Submit([this, path, request, face]()
+        {
+            if (!threadPool->IsCancelled())
             {
-                GLenum format = (nrComponents == 4) ? GL_RGBA : GL_RGB;
-                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                             0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-                stbi_image_free(data);
+                DecodedImage image = Decode(path, request, face);
+                RecordDecode(image);
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completed.push_back(std::move(image));
             }
+
+            if (inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                inFlight.notify_all();
+        });
+    }
+
+    // Returns true if the texture is now resident (or given up on)
+    bool Finish(DecodedImage&& image)
+    {
+        auto it = pending.find(image.request);
+        if (it == pending.end())
+            return false;   // unloaded while decoding
+
+        PendingTexture& texture = it->second;
+        auto start = std::chrono::steady_clock::now();
+
+        if (!image.pixels && !image.cooked.valid)
+        {
+            Logger::Log(LogLevel::ERROR, LogCategory::RENDERING,
+                "Texture failed to load at path: " + texture.path);
+            stats.failed++;
+            pending.erase(it);
+            return true;
+        }
+
+        TextureInfo info;
+        info.path = texture.path;
+        info.loadMs = image.decodeMs;
+
+        if (image.cooked.valid)
+        {
+            const CookedTexture& cooked = image.cooked;
+            glBindTexture(texture.target, texture.id);
+            UploadCooked(texture.target, cooked);
+
+            info.format = GetTextureFormatInfo(cooked.format).name;
+            info.width = cooked.width;
+            info.height = cooked.height;
+            info.levels = static_cast<int>(cooked.levels.size());
+            info.vramBytes = cooked.GetMemorySize();
+            info.fromCache = cooked.fromCache;
+
+            if (cooked.fromCache)
+                stats.cacheHits++;
             else
+                stats.cacheMisses++;
+        }
+        else if (texture.target == GL_TEXTURE_2D)
+        {
+            glBindTexture(GL_TEXTURE_2D, texture.id);
+            UploadImage(GL_TEXTURE_2D, image);
+            SetTexture2DParameters(image.channels);
+
+            // Driver-side estimate: uncompressed, full mip chain
+            info.format = "uncompressed";
+            info.width = image.width;
+            info.height = image.height;
+            info.levels = static_cast<int>(std::floor(std::log2(std::max(image.width, image.height)))) + 1;
+            info.vramBytes = static_cast<size_t>(image.width) * image.height * 4 * 4 / 3;
+        }
+        else
+        {
+            texture.faces.push_back(std::move(image));
+            if (texture.faces.size() < 6)
+                return false;
+
+            glBindTexture(GL_TEXTURE_CUBE_MAP, texture.id);
+            for (const auto& face : texture.faces)
             {
-                Logger::Log(LogLevel::ERROR, "Cubemap texture failed to load at path: " + faces[i]);
-                return 0;
+                UploadImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face.face, face);
+                info.loadMs += face.decodeMs;
             }
+            SetCubemapParameters();
+
+            info.format = "uncompressed";
+            info.width = texture.faces[0].width;
+            info.height = texture.faces[0].height;
+            info.levels = 1;
+            info.vramBytes = static_cast<size_t>(info.width) * info.height * 4 * 6;
         }
 
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glBindTexture(texture.target, 0);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        stats.uploadMs += elapsed.count();
+        stats.uploaded++;
+
+        info.loadMs += elapsed.count();
+        stats.vramBytes += info.vramBytes;
 
+        Logger::Log(LogLevel::DEBUG, LogCategory::RENDERING, "Texture ready: " + info.path + " " +
+            std::to_string(info.width) + "x" + std::to_string(info.height) + " " + info.format + ", " +
+            std::to_string(info.levels) + " levels, " + std::to_string(info.vramBytes / 1024) + " KiB, " +
+            std::to_string(info.loadMs) + " ms" + (info.fromCache ? " (cached)" : ""));
+
+        auto previous = textureInfo.find(texture.id);
+        if (previous != textureInfo.end())
+            stats.vramBytes -= previous->second.vramBytes;
+        textureInfo[texture.id] = std::move(info);
+
+        pending.erase(it);
+        return true;
+    }
+
+    unsigned int CreateWithPlaceholder(GLenum target)
+    {
+        const DecodedImage& image = GetPlaceholder();
+        GLenum format = FormatFor(image.channels);
+
+        unsigned int textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(target, textureID);
+
+        if (target == GL_TEXTURE_2D)
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.get());
+            SetTexture2DParameters(image.channels);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < 6; i++)
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, image.width, image.height, 0,
+                    format, GL_UNSIGNED_BYTE, image.pixels.get());
+            SetCubemapParameters();
+        }
+
+        glBindTexture(target, 0);
         return textureID;
     }
 
+    void ForgetInfo(unsigned int textureID)
+    {
+        auto it = textureInfo.find(textureID);
+        if (it != textureInfo.end())
+        {
+            stats.vramBytes -= it->second.vramBytes;
+            textureInfo.erase(it);
+        }
+    }
+
+    void CancelPending(unsigned int textureID)
+    {
+        for (auto it = pending.begin(); it != pending.end(); )
+        {
+            if (it->second.id == textureID)
+                it = pending.erase(it);
+            else
+                ++it;
+        }
+    }
+
 public:
-    TextureManager() = default;
+    explicit TextureManager(ThreadPool* pool = nullptr)
+        : threadPool(pool)
+    {}
 
     ~TextureManager()
     {
+        WaitForDecodes();
         UnloadAll();
+
+        if (pbos[0] != 0)
+            glDeleteBuffers(PBO_COUNT, pbos);
     }
 
-    unsigned int LoadTexture(const std::string& path, bool gamma = false)
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+
+    // Returns immediately; the texture shows the placeholder until ProcessUploads
+    // makes the decoded image resident. Concurrent requests for the same path and
+    // usage share one decode; a different usage is a different texture.
+    unsigned int LoadTexture(const std::string& path, TextureUsage usage = TextureUsage::COLOR)
     {
-        if (IsLoaded(path)) return loadedTextures[path];
-        unsigned int textureID = LoadTextureFromFile(path.c_str(), gamma);
-        if (textureID != 0)
-            loadedTextures[path] = textureID;
+        QueryFormatSupport();
+
+        std::string key = MakeKey(path, usage);
+
+        stats.requested++;
+        if (IsLoaded(path, usage))
+        {
+            stats.deduplicated++;
+            return loadedTextures[key];
+        }
+
+        unsigned int textureID = CreateWithPlaceholder(GL_TEXTURE_2D);
+        loadedTextures[key] = textureID;
+
+        uint64_t request = nextRequest++;
+        pending.emplace(request, PendingTexture{ request, textureID, GL_TEXTURE_2D, path, {} });
+        QueueLoad({ path }, request, usage);
+
+        if (!threadPool || !asyncLoading)
+            ProcessUploads(0.0);
+
         return textureID;
     }
 
     unsigned int LoadCubemap(const std::vector<std::string>& faces)
     {
+        QueryFormatSupport();
+
         std::string key = "cubemap_";
         for (const auto& face : faces) key += face;
-        if (IsLoaded(key)) return loadedTextures[key];
-        unsigned int textureID = LoadCubemapFromFiles(faces);
-        if (textureID != 0) loadedTextures[key] = textureID;
+
+        stats.requested++;
+        if (loadedTextures.contains(key))
+        {
+            stats.deduplicated++;
+            return loadedTextures[key];
+        }
+
+        if (faces.size() != 6)
+        {
+            Logger::Log(LogLevel::ERROR, LogCategory::RENDERING,
+                "Cubemap needs 6 faces, got " + std::to_string(faces.size()));
+            return 0;
+        }
+
+        unsigned int textureID = CreateWithPlaceholder(GL_TEXTURE_CUBE_MAP);
+        loadedTextures[key] = textureID;
+
+        uint64_t request = nextRequest++;
+        pending.emplace(request, PendingTexture{ request, textureID, GL_TEXTURE_CUBE_MAP, key, {} });
+        QueueLoad(faces, request, TextureUsage::COLOR);
+
+        if (!threadPool || !asyncLoading)
+            ProcessUploads(0.0);
+
         return textureID;
     }
 
+    // Uploads decoded images until the budget is spent; at least one per call so
+    // loading always progresses. A budget <= 0 drains everything available.
+    size_t ProcessUploads(double budgetMs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            for (auto& image : completed)
+                ready.push_back(std::move(image));
+            completed.clear();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t finished = 0;
+
+        while (!ready.empty())
+        {
+            DecodedImage image = std::move(ready.front());
+            ready.pop_front();
+
+            if (Finish(std::move(image)))
+                finished++;
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if (budgetMs > 0.0 && elapsed.count() >= budgetMs)
+                break;
+        }
+
+        return finished;
+    }
+
+    // Blocks until every queued decode has finished (not uploaded)
+    void WaitForDecodes()
+    {
+        size_t remaining;
+        while ((remaining = inFlight.load(std::memory_order_acquire)) != 0)
+            inFlight.wait(remaining);
+    }
+
+    void SetAsyncLoading(bool enabled) { asyncLoading = enabled; }
+
+    // Render thread; runs once, before the first load
+    void QueryFormatSupport()
+    {
+        if (formatsQueried)
+            return;
+        cache.QueryFormatSupport();
+        formatsQueried = true;
+    }
+
+    // Only affects textures requested afterwards
+    void SetCacheEnabled(bool enabled) { cacheEnabled = enabled; }
+    void SetCompression(bool enabled) { cache.SetCompression(enabled); }
+    bool IsCacheEnabled() const { return cacheEnabled; }
+
+    std::vector<TextureInfo> GetTextureInfo() const
+    {
+        std::vector<TextureInfo> infos;
+        for (const auto& [id, info] : textureInfo)
+            infos.push_back(info);
+        return infos;
+    }
+    bool IsAsyncLoading() const { return asyncLoading && threadPool; }
+
+    size_t GetPendingCount() const { return pending.size(); }
+    bool IsPending(unsigned int textureID) const
+    {
+        for (const auto& [request, texture] : pending)
+            if (texture.id == textureID)
+                return true;
+        return false;
+    }
+
+    TextureLoadStats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        return stats;
+    }
+
     void BindTexture(unsigned int textureID, unsigned int slot = 0)
     {
         glActiveTexture(GL_TEXTURE0 + slot);
         glBindTexture(GL_TEXTURE_2D, textureID);
+        Profiler::Count(ProfileCounter::TEXTURE_BINDS);
     }
 
-    void UnloadTexture(const std::string& path)
+    void UnloadTexture(const std::string& path, TextureUsage usage = TextureUsage::COLOR)
     {
-        auto it = loadedTextures.find(path);
+        auto it = loadedTextures.find(MakeKey(path, usage));
         if (it != loadedTextures.end())
         {
+            CancelPending(it->second);
+            ForgetInfo(it->second);
             glDeleteTextures(1, &it->second);
             loadedTextures.erase(it);
         }
@@ -128,10 +680,14 @@ public:
         for (auto& pair : loadedTextures)
             glDeleteTextures(1, &pair.second);
         loadedTextures.clear();
+        textureInfo.clear();
+        stats.vramBytes = 0;
+        pending.clear();
+        ready.clear();
     }
 
-    bool IsLoaded(const std::string& path) const
+    bool IsLoaded(const std::string& path, TextureUsage usage = TextureUsage::COLOR) const
     {
-        return loadedTextures.find(path) != loadedTextures.end();
+        return loadedTextures.find(MakeKey(path, usage)) != loadedTextures.end();
     }
 };
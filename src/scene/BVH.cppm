@@ -0,0 +1,399 @@
+module;
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+export module XEngine.Scene.BVH;
+
+import XEngine.Rendering.Bounds;
+
+// Dynamic AABB tree. Leaves store fattened boxes so small movements don't touch
+// the tree; only proxies that leave their fat box are reinserted. Internal nodes
+// are kept balanced with AVL-style rotations on every insert/remove.
+export class DynamicBVH
+{
+public:
+    static constexpr int NULL_NODE = -1;
+
+private:
+    struct Node
+    {
+        AABB box;
+        uint32_t userData = 0;
+        int parent = NULL_NODE;     // doubles as the free-list link
+        int left = NULL_NODE;
+        int right = NULL_NODE;
+        int height = -1;            // -1 for free nodes, 0 for leaves
+
+        bool IsLeaf() const { return left == NULL_NODE; }
+        bool IsFree() const { return height < 0; }
+    };
+
+    std::vector<Node> nodes;
+    int root = NULL_NODE;
+    int freeList = NULL_NODE;
+    size_t proxyCount = 0;
+    float margin;
+
+    mutable std::vector<int> stack;
+
+    int AllocateNode()
+    {
+        if (freeList == NULL_NODE)
+        {
+            nodes.emplace_back();
+            return static_cast<int>(nodes.size() - 1);
+        }
+
+        int node = freeList;
+        freeList = nodes[node].parent;
+        nodes[node] = Node{};
+        return node;
+    }
+
+    void FreeNode(int node)
+    {
+        nodes[node].parent = freeList;
+        nodes[node].height = -1;
+        freeList = node;
+    }
+
+    void InsertLeaf(int leaf)
+    {
+        if (root == NULL_NODE)
+        {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+
+        // Walk down choosing the child with the lowest surface-area cost
+        const AABB leafBox = nodes[leaf].box;
+        int index = root;
+        while (!nodes[index].IsLeaf())
+        {
+            int left = nodes[index].left;
+            int right = nodes[index].right;
+
+            float area = nodes[index].box.GetArea();
+            float combinedArea = AABB::Union(nodes[index].box, leafBox).GetArea();
+
+            float cost = 2.0f * combinedArea;
+            float inheritance = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int child)
+            {
+                float unionArea = AABB::Union(leafBox, nodes[child].box).GetArea();
+                return nodes[child].IsLeaf() ? unionArea + inheritance
+                                             : unionArea - nodes[child].box.GetArea() + inheritance;
+            };
+
+            float costLeft = descendCost(left);
+            float costRight = descendCost(right);
+
+            if (cost < costLeft && cost < costRight)
+                break;
+
+            index = costLeft < costRight ? left : right;
+        }
+
+        int sibling = index;
+        int oldParent = nodes[sibling].parent;
+        int newParent = AllocateNode();
+
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = AABB::Union(leafBox, nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].left = sibling;
+        nodes[newParent].right = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if (oldParent == NULL_NODE)
+            root = newParent;
+        else if (nodes[oldParent].left == sibling)
+            nodes[oldParent].left = newParent;
+        else
+            nodes[oldParent].right = newParent;
+
+        Refit(nodes[leaf].parent);
+    }
+
+    void RemoveLeaf(int leaf)
+    {
+        if (leaf == root)
+        {
+            root = NULL_NODE;
+            return;
+        }
+
+        int parent = nodes[leaf].parent;
+        int grandParent = nodes[parent].parent;
+        int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+        if (grandParent == NULL_NODE)
+        {
+            root = sibling;
+            nodes[sibling].parent = NULL_NODE;
+            FreeNode(parent);
+            return;
+        }
+
+        if (nodes[grandParent].left == parent)
+            nodes[grandParent].left = sibling;
+        else
+            nodes[grandParent].right = sibling;
+
+        nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    }
+
+    // Rebalances and refits boxes from index up to the root
+    void Refit(int index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = Balance(index);
+
+            Node& node = nodes[index];
+            node.height = 1 + std::max(nodes[node.left].height, nodes[node.right].height);
+            node.box = AABB::Union(nodes[node.left].box, nodes[node.right].box);
+
+            index = node.parent;
+        }
+    }
+
+    // Rotates the taller grandchild up if the subtree at a is unbalanced. Returns the new subtree root.
+    int Balance(int a)
+    {
+        Node& A = nodes[a];
+        if (A.IsLeaf() || A.height < 2)
+            return a;
+
+        int b = A.left;
+        int c = A.right;
+        int balance = nodes[c].height - nodes[b].height;
+
+        if (balance > 1)
+            return Rotate(a, c, b);
+        if (balance < -1)
+            return Rotate(a, b, c);
+        return a;
+    }
+
+    // Promotes child "up" above a; "other" stays a's child
+    int Rotate(int a, int up, int other)
+    {
+        int f = nodes[up].left;
+        int g = nodes[up].right;
+
+        nodes[up].left = a;
+        nodes[up].parent = nodes[a].parent;
+        nodes[a].parent = up;
+
+        if (nodes[up].parent == NULL_NODE)
+            root = up;
+        else if (nodes[nodes[up].parent].left == a)
+            nodes[nodes[up].parent].left = up;
+        else
+            nodes[nodes[up].parent].right = up;
+
+        // Keep the taller grandchild on top, hand the shorter one down to a
+        int keep = nodes[f].height > nodes[g].height ? f : g;
+        int give = keep == f ? g : f;
+
+        nodes[up].right = keep;
+        if (nodes[a].left == up)
+            nodes[a].left = give;
+        else
+            nodes[a].right = give;
+        nodes[give].parent = a;
+
+        nodes[a].box = AABB::Union(nodes[other].box, nodes[give].box);
+        nodes[a].height = 1 + std::max(nodes[other].height, nodes[give].height);
+
+        nodes[up].box = AABB::Union(nodes[a].box, nodes[keep].box);
+        nodes[up].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+
+        return up;
+    }
+
+    template<typename Func>
+    void CollectLeaves(int index, Func& func) const
+    {
+        size_t base = stack.size();
+        stack.push_back(index);
+        while (stack.size() > base)
+        {
+            int current = stack.back();
+            stack.pop_back();
+
+            const Node& node = nodes[current];
+            if (node.IsLeaf())
+                func(node.userData);
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+public:
+    explicit DynamicBVH(float fatMargin = 0.1f) : margin(fatMargin) {}
+
+    int CreateProxy(const AABB& box, uint32_t userData)
+    {
+        int leaf = AllocateNode();
+        nodes[leaf].box = box.Fattened(margin);
+        nodes[leaf].userData = userData;
+        nodes[leaf].height = 0;
+
+        InsertLeaf(leaf);
+        proxyCount++;
+        return leaf;
+    }
+
+    void DestroyProxy(int proxy)
+    {
+        // Freed nodes still look like leaves, so a double destroy would corrupt the free list
+        if (proxy == NULL_NODE || proxy >= static_cast<int>(nodes.size()) || nodes[proxy].IsFree() || !nodes[proxy].IsLeaf())
+            return;
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        proxyCount--;
+    }
+
+    // Returns true if the proxy had to be reinserted
+    bool MoveProxy(int proxy, const AABB& box)
+    {
+        if (nodes[proxy].box.Contains(box))
+            return false;
+
+        RemoveLeaf(proxy);
+        nodes[proxy].box = box.Fattened(margin);
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void Clear()
+    {
+        nodes.clear();
+        root = NULL_NODE;
+        freeList = NULL_NODE;
+        proxyCount = 0;
+    }
+
+    // Subtrees fully inside the frustum are reported without further plane tests
+    template<typename Func>
+    void QueryFrustum(const Frustum& frustum, Func&& func) const
+    {
+        if (root == NULL_NODE)
+            return;
+
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+
+            const Node& node = nodes[index];
+            FrustumTest test = frustum.Test(node.box);
+            if (test == FrustumTest::OUTSIDE)
+                continue;
+
+            if (node.IsLeaf())
+                func(node.userData);
+            else if (test == FrustumTest::INSIDE)
+                CollectLeaves(index, func);
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    template<typename Func>
+    void QueryAABB(const AABB& box, Func&& func) const
+    {
+        if (root == NULL_NODE)
+            return;
+
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (!node.box.Overlaps(box))
+                continue;
+
+            if (node.IsLeaf())
+                func(node.userData);
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    // func(userData, distance) returns the distance of the confirmed hit, or a
+    // negative value to ignore the proxy. Returns the nearest confirmed distance
+    // or a negative value when nothing was hit.
+    template<typename Func>
+    float RayCast(const Ray& ray, float maxDistance, Func&& func) const
+    {
+        float nearest = maxDistance;
+        bool hit = false;
+
+        if (root == NULL_NODE)
+            return -1.0f;
+
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+
+            float distance = ray.Intersect(node.box, nearest);
+            if (distance < 0.0f)
+                continue;
+
+            if (node.IsLeaf())
+            {
+                float confirmed = func(node.userData, distance);
+                if (confirmed >= 0.0f && confirmed < nearest)
+                {
+                    nearest = confirmed;
+                    hit = true;
+                }
+            }
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+
+        return hit ? nearest : -1.0f;
+    }
+
+    const AABB& GetFatBounds(int proxy) const { return nodes[proxy].box; }
+    uint32_t GetUserData(int proxy) const { return nodes[proxy].userData; }
+
+    size_t GetProxyCount() const { return proxyCount; }
+    size_t GetNodeCount() const { return proxyCount == 0 ? 0 : proxyCount * 2 - 1; }
+    int GetHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+};
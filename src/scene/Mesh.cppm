@@ -6,19 +6,21 @@ module;
 
 #include <vector>
 #include <memory>
+#include <utility>
 
 export module XEngine.Scene.Mesh;
 
 import XEngine.Resource.Shader.ShaderManager;
 
 import XEngine.Rendering.Material;
+import XEngine.Rendering.Bounds;
 import XEngine.Rendering.GPUMesh;
 import XEngine.Rendering.MeshData;
 
 export class Mesh 
 {
 private:
-    std::unique_ptr<GPUMesh> gpuMesh;
+    std::shared_ptr<GPUMesh> gpuMesh;
     std::shared_ptr<Material> material;
 
 public:
@@ -34,6 +36,10 @@ public:
         material = std::unique_ptr<Material>(materialPtr);
     }
 
+    Mesh(std::shared_ptr<GPUMesh> sharedGPUMesh, std::shared_ptr<Material> sharedMaterial)
+        : gpuMesh(std::move(sharedGPUMesh)), material(std::move(sharedMaterial))
+    {}
+
     void Draw(ShaderManager& shaderManager, const std::string& name)
     {  
         if (material)
@@ -83,4 +89,7 @@ public:
     }
 
     glm::vec3 GetColor() const { return material->GetColor(); }
+    GPUMesh* GetGPUMesh() const { return gpuMesh.get(); }
+    const AABB& GetBounds() const { return gpuMesh->GetBounds(); }
+    std::shared_ptr<Material> GetMaterial() const { return material; }
 };
\ No newline at end of file